@@ -1,10 +1,16 @@
 #include <SDL3/SDL.h>
 #include <GL/glew.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <string>
+#include <memory>
+#include <filesystem>
+#include <unordered_set>
 
 // ImGui
 #include "imgui.h"
@@ -13,15 +19,42 @@
 
 // Project Headers
 #include "Matrix4x4.hpp"
+#include "Affine3.hpp"
 #include "utils/Mesh.hpp"          // Cont la classe Mesh (Cube)
 #include "utils/GraphicsUtils.hpp" // Cont helpers per OpenGL
 
 #include "Transform.hpp"
 #include "GameObject.hpp"
 #include "Camera.hpp"
+#include "Skeleton.hpp"
+#include "SceneBVH.hpp"
+#include "HierarchyView.hpp"
+#include "Selection.hpp"
+#include "CommandJournal.hpp"
+#include "JobSystem.hpp"
+#include "OcclusionCuller.hpp"
+#include "RenderQueue.hpp"
+#include "utils/SkinnedMesh.hpp"
+#include "utils/MeshPool.hpp"
+#include "utils/IndirectRenderer.hpp"
+#include "utils/GpuCuller.hpp"
+#include "utils/RenderTarget.hpp"
+#include "utils/FrameReadback.hpp"
+#include "FrameWriter.hpp"
+#include "FixedTimestep.hpp"
+#include "FramePipeline.hpp"
+#include "CommandBuffer.hpp"
+#include "utils/CommandReplay.hpp"
+#include "utils/ShaderCache.hpp"
+#include "utils/ShaderVariants.hpp"
+#include "LightClusters.hpp"
+#include "utils/LightBuffers.hpp"
+#include "ShaderWatcher.hpp"
+#include "AssetManager.hpp"
+#include "utils/GpuAssets.hpp"
+#include "WorldPartition.hpp"
 
 float cameraSpeed = 5.0f;
-Uint64 lastTicks = 0;
 
 bool keyW = false;
 bool keyA = false;
@@ -35,6 +68,15 @@ int lastMouseX = 0;
 int lastMouseY = 0;
 
 float mouseSensitivity = 0.0025f;
+
+// Modo "on demand": sin cambios en la escena, la camara o la entrada no se redibuja. Cada cambio pide
+// unos frames extra para que ImGui acabe sus transiciones y el Hi-Z se ponga al dia antes de dormir
+bool redrawOnDemand = true;
+int pendingRedraws = 0;
+
+void RequestRedraw(int frames = 3) {
+    if (pendingRedraws < frames) pendingRedraws = frames;
+}
 // -----------------------------------------------------------------------------
 // HELPER: Crrega de fitxers de text (per Shaders)
 // -----------------------------------------------------------------------------
@@ -68,118 +110,737 @@ GLuint CompileShader(GLenum type, const std::string& source) {
     return shader;
 }
 
-GLuint CreateShaderProgram(const std::string& vertPath, const std::string& fragPath) {
-    std::string vertCode = LoadShaderFile(vertPath);
-    std::string fragCode = LoadShaderFile(fragPath);
-
-    if (vertCode.empty() || fragCode.empty()) return 0;
-
-    GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertCode);
-    GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragCode);
+// -----------------------------------------------------------------------------
+// HELPER: Programas (cache de binarios + recarga en caliente)
+// -----------------------------------------------------------------------------
+ShaderCache shaderCache;
+bool shaderCacheEnabled = false; // ShaderCache::Supported() al crear el contexto
+
+// stages: (tipo, fuente). Con cache se prueba antes el binario guardado; si no vale se compila y se guarda
+GLuint LinkProgram(const std::vector<std::pair<GLenum, std::string>>& stages) {
+    uint64_t key = 0;
+    if (shaderCacheEnabled) {
+        key = ShaderCache::Key(stages);
+        GLuint cached = shaderCache.Load(key);
+        if (cached != 0) return cached;
+    }
 
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    GLuint program = glCreateProgram();
+    std::vector<GLuint> shaders;
+    for (const auto& stage : stages) {
+        shaders.push_back(CompileShader(stage.first, stage.second));
+        glAttachShader(program, shaders.back());
+    }
+    if (shaderCacheEnabled) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    for (GLuint shader : shaders) glDeleteShader(shader);
 
     int success;
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
         char infoLog[512];
-        glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
         std::cerr << "ERROR::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    if (shaderCacheEnabled) shaderCache.Store(key, program);
+    return program;
+}
+
+// files: (tipo, ruta); sources: (tipo, fuente)
+bool LoadSources(const std::vector<std::pair<GLenum, std::string>>& files, std::vector<std::pair<GLenum, std::string>>& sources) {
+    sources.clear();
+    for (const auto& file : files) {
+        std::string code = LoadShaderFile(file.second);
+        if (code.empty()) return false;
+        sources.push_back({ file.first, std::move(code) });
+    }
+    return true;
+}
+
+GLuint CreateProgramFromFiles(const std::vector<std::pair<GLenum, std::string>>& files) {
+    std::vector<std::pair<GLenum, std::string>> stages;
+    if (!LoadSources(files, stages)) return 0;
+    return LinkProgram(stages);
+}
+
+GLuint CreateComputeProgram(const std::string& path) {
+    return CreateProgramFromFiles({ { GL_COMPUTE_SHADER, path } });
+}
+
+// Estado que no sobrevive a glProgramBinary ni a una recarga: hay que ponerlo en cada programa nuevo
+void BindSkinPaletteBlock(GLuint program) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, "SkinPalette");
+    if (blockIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, blockIndex, SKIN_PALETTE_BINDING);
+}
+
+void SetupSurfaceProgram(GLuint program) {
+    BindSkinPaletteBlock(program);
+    LightBuffers::SetupProgram(program);
+}
+
+std::vector<std::pair<GLuint, int>> retiredPrograms; // (programa, frames que faltan)
+
+// El frame que el pipeline tiene en vuelo aun puede usar el programa: se borra unos frames despues
+void RetireProgram(GLuint program) {
+    retiredPrograms.push_back({ program, 3 });
+}
+
+// Shader de superficie: una sola fuente (vs.glsl + fs.glsl) especializada por mascara de ShaderFeature
+const std::vector<std::pair<GLenum, std::string>> surfaceShaderFiles = { { GL_VERTEX_SHADER, "vs.glsl" }, { GL_FRAGMENT_SHADER, "fs.glsl" } };
+ShaderVariants surfaceShaders;
+
+bool UsesAnyFile(const std::vector<std::pair<GLenum, std::string>>& files, const std::vector<std::string>& changedFiles) {
+    for (const auto& file : files)
+        for (const std::string& changed : changedFiles)
+            if (file.second == changed) return true;
+    return false;
+}
+
+// Recarga en caliente: cada programa recuerda sus ficheros y la variable donde vive. Todo se recompila
+// en segundo plano (las variantes de superficie en ShaderVariants, el resto en pending) y se sigue
+// usando el programa anterior hasta que el nuevo enlaza; si falla se queda el anterior
+struct ReloadableProgram {
+    std::vector<std::pair<GLenum, std::string>> files;
+    GLuint* program = nullptr;
+    void (*setup)(GLuint) = nullptr;
+    AsyncProgram pending;
+    uint64_t key = 0; // ShaderCache del que esta en pending
+};
+std::vector<ReloadableProgram> reloadablePrograms;
+
+void InstallReloaded(ReloadableProgram& reloadable, GLuint program) {
+    if (reloadable.setup) reloadable.setup(program);
+    if (*reloadable.program != 0) RetireProgram(*reloadable.program);
+    *reloadable.program = program;
+    std::cout << "Shader reloaded: " << reloadable.files[0].second << std::endl;
+}
+
+void ReloadPrograms(const std::vector<std::string>& changedFiles) {
+    if (UsesAnyFile(surfaceShaderFiles, changedFiles)) {
+        std::vector<std::pair<GLenum, std::string>> sources;
+        if (LoadSources(surfaceShaderFiles, sources)) surfaceShaders.SetSources(std::move(sources));
+    }
+
+    for (ReloadableProgram& reloadable : reloadablePrograms) {
+        if (!UsesAnyFile(reloadable.files, changedFiles)) continue;
+
+        std::vector<std::pair<GLenum, std::string>> stages;
+        if (!LoadSources(reloadable.files, stages)) {
+            std::cerr << "Shader reload failed, keeping the previous program: " << reloadable.files[0].second << std::endl;
+            continue;
+        }
+        // Guardado otra vez antes de que acabe el anterior: gana el ultimo
+        reloadable.pending.Abort();
+        if (shaderCacheEnabled) {
+            reloadable.key = ShaderCache::Key(stages);
+            const GLuint cached = shaderCache.Load(reloadable.key);
+            if (cached != 0) {
+                InstallReloaded(reloadable, cached);
+                continue;
+            }
+        }
+        reloadable.pending.Begin(stages, shaderCacheEnabled);
+    }
+}
+
+// Una vez por frame, como ShaderVariants::Poll: sin compilacion en paralelo se espera a uno por
+// llamada. Devuelve los que siguen compilandose
+uint32_t PollReloadedPrograms() {
+    const bool parallel = AsyncProgram::ParallelSupported();
+    uint32_t left = 0;
+    bool finished = false;
+    for (ReloadableProgram& reloadable : reloadablePrograms) {
+        if (!reloadable.pending.Pending()) continue;
+        if (parallel ? !reloadable.pending.Done() : finished) {
+            ++left;
+            continue;
+        }
+
+        finished = true;
+        const GLuint program = reloadable.pending.Finish(reloadable.files[0].second);
+        if (program == 0) {
+            std::cerr << "Shader reload failed, keeping the previous program: " << reloadable.files[0].second << std::endl;
+            continue;
+        }
+        if (shaderCacheEnabled) shaderCache.Store(reloadable.key, program);
+        InstallReloaded(reloadable, program);
     }
+    return left;
+}
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    return shaderProgram;
+// Una vez por frame dibujado
+void CollectRetiredPrograms() {
+    for (std::size_t i = 0; i < retiredPrograms.size();) {
+        if (--retiredPrograms[i].second > 0) { ++i; continue; }
+        glDeleteProgram(retiredPrograms[i].first);
+        retiredPrograms.erase(retiredPrograms.begin() + i);
+    }
 }
 
 // -----------------------------------------------------------------------------
 // UI: (TODO)
 // -----------------------------------------------------------------------------
-GameObject* selectedObject = nullptr;
+Selection selection;
+HierarchyView hierarchyView;
+CommandJournal journal;
+
+// -----------------------------------------------------------------------------
+// SKINNING
+// -----------------------------------------------------------------------------
+struct SkinnedCharacter {
+    Skeleton skeleton;
+    SkinnedMesh mesh;
+};
+
+SkinnedCharacter* CreateSkinnedChain(std::vector<GameObject*>& sceneRoots, int segments) {
+    SkinnedCharacter* character = new SkinnedCharacter();
+
+    GameObject* parent = nullptr;
+    for (int i = 0; i < segments; ++i) {
+        GameObject* joint = new GameObject("Joint" + std::to_string(i));
+        if (parent) {
+            joint->transform.position = { 0.0, 1.0, 0.0 };
+            parent->AddChild(joint);
+        }
+        else {
+            sceneRoots.push_back(joint);
+        }
+        character->skeleton.AddJoint(joint);
+        parent = joint;
+    }
+
+    character->skeleton.Bind();
+    character->mesh.InitBoxChain(segments, 1.0f);
+    return character;
+}
+
+// Paleta (y en el camino CPU, vertices ya deformados) de un personaje en un frame
+struct SkinnedFrame {
+    SkinnedCharacter* character = nullptr;
+    SkinningPath path = SkinningPath::CPU;
+    std::vector<float> palette;
+    std::vector<float> vertices;
+};
+
+// Hilo de simulacion: solo lee la escena y escribe en el frame
+// origin: la paleta deja los vertices relativos a la camara
+void ComputeSkinned(SkinnedFrame& skinned, SkinningBlend blend, const Vec3& origin) {
+    const SkinnedCharacter& character = *skinned.character;
+    if (blend == SkinningBlend::DualQuat)
+        character.skeleton.ComputeDualQuatPalette(skinned.palette, origin);
+    else
+        character.skeleton.ComputePalette(skinned.palette, origin);
+
+    if (skinned.path == SkinningPath::CPU)
+        character.mesh.SkinCPU(skinned.palette, blend, skinned.vertices);
+}
+
+// Hilo de GL, antes del replay: solo sube datos; cada draw enlaza su paleta con BindUniformBuffer
+void UploadSkinned(const SkinnedFrame& skinned) {
+    if (skinned.path == SkinningPath::GPU)
+        skinned.character->mesh.UploadPaletteGPU(skinned.palette);
+    else
+        skinned.character->mesh.UploadSkinned(skinned.vertices);
+}
 
-void DrawHierarchyNode(GameObject* node) {
+// -----------------------------------------------------------------------------
+// RENDER QUEUE
+// -----------------------------------------------------------------------------
+// Un registro por objeto visible; la cola ordena los indices y RecordCommands agrupa
+struct DrawRecord {
+    GLuint program = 0;
+    Mesh* mesh = nullptr;                   // objetos de la escena (instanciados)
+    int poolMesh = -1;                      // >= 0: malla del MeshPool (camino indirecto)
+    SkinnedCharacter* character = nullptr;  // personajes con skinning (la paleta ya esta subida)
+    SkinningPath path = SkinningPath::CPU;
+    Affine3f model;
+    GLuint texture = 0;                     // unidad 0; la blanca si no tiene
+};
+
+// Materiales: color y textura. La clave solo tiene 12 bits para el material, asi que dos texturas pueden
+// compartir valor: RecordCommands compara la textura antes de juntar draws
+enum : uint32_t { MaterialScene = 0, MaterialSkinned = 1, MaterialTextured = 2 };
+
+uint32_t SceneMaterial(GLuint texture, const GpuAssets& assets) {
+    return texture == assets.whiteTexture ? MaterialScene : MaterialTextured + texture % (0xFFF - MaterialTextured);
+}
+
+// Todo lo que el hilo de GL necesita para dibujar un frame sin leer la escena. Hay dos (FramePipeline):
+// el hilo de simulacion rellena uno mientras el de GL dibuja el otro
+struct FrameSnapshot {
+    // Entrada: la pone el hilo principal antes del Kick
+    Camera camera;
+    bool useGpuCulling = false;
+    bool useIndirect = false;
+    bool useOcclusionCulling = false;
+    bool useClusteredLights = false;
+    bool gatherCullInstances = false; // la escena ha cambiado: hay que resubir las instancias del culling GPU
+    int viewportHeight = 1;           // pixels: da el tamano en pantalla de las texturas
+    // Todo lo que llega a la GPU es relativo a origin (restado en double): la camara, o con culling GPU
+    // el origen de sus instancias, que no se recorren cada frame
+    Vec3 origin;
+    SkinningPath skinningPath = SkinningPath::CPU;
+    SkinningBlend skinningBlend = SkinningBlend::Linear;
+    // Variantes ya resueltas en el hilo de GL (compilar no se puede desde el hilo de simulacion).
+    // skinnedProgram == 0: el skinning se hace en CPU
+    GLuint sceneProgram = 0;
+    GLuint skinnedProgram = 0;
+
+    // Salida. view es la completa, para los calculos en double; renderView es la de la GPU: solo rota
+    // (mas el desplazamiento pequeno de la camara respecto a origin)
+    Matrix4x4 view, renderView, proj;
+    RenderQueue queue; // ya ordenada
+    std::vector<DrawRecord> drawRecords;
+    std::vector<SkinnedFrame> skinned;
+    std::vector<GpuCullInstance> cullInstances;
+    std::vector<uint32_t> cullMeshIds;
+    std::vector<CommandBuffer> commands; // grabadas en paralelo, se reproducen en orden
+    LightClusters clusters;
+    // Por id de textura: lado en pixels del mayor objeto que la usa (GpuAssets::StreamTextures)
+    std::unordered_map<uint32_t, float> textureFootprints;
+};
+
+uint32_t ViewDepth(const FrameSnapshot& frame, const Vec3& worldPos) {
+    // La camara mira hacia -Z
+    return RenderQueue::QuantizeDepth(-frame.view.TransformPoint(worldPos).z, frame.camera.nearPlane, frame.camera.farPlane);
+}
+
+// Resta origin en double antes de pasar a float: a kilometros del origen del mundo la traslacion en
+// float ya no tiene precision para el detalle y la imagen tiembla
+Affine3f RelativeTo(const Affine3& world, const Vec3& origin) {
+    Affine3 relative = world;
+    relative.At(0, 3) -= origin.x;
+    relative.At(1, 3) -= origin.y;
+    relative.At(2, 3) -= origin.z;
+    return Affine3f(relative);
+}
+
+// La malla de cada nodo sale de assets (cubo mientras no este subida). usePool: se dibuja con el MeshPool.
+// occlusion != nullptr: los objetos tapados por oclusores no llegan a la cola (sus hijos se prueban aparte)
+void GatherDraws(GameObject* node, GLuint program, const GpuAssets& assets, bool usePool, FrameSnapshot& frame, const OcclusionCuller* occlusion) {
     if (!node) return;
 
-    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick;
-    if (node == selectedObject) {
-        flags |= ImGuiTreeNodeFlags_Selected;
+    // Global cacheada: solo se recalcula la de los nodos sucios
+    const Affine3& world = node->GetGlobalMatrix();
+    const GpuAssets::MeshEntry& mesh = assets.MeshFor(node->mesh);
+
+    // Las luces no tienen malla
+    const bool hidden = node->light.type != LightType::None ||
+                        (occlusion && !node->occluder && !occlusion->IsVisible(AABB::FromOBB(world, mesh.halfExtents)));
+    if (hidden) {
+        for (GameObject* child : node->children)
+            GatherDraws(child, program, assets, usePool, frame, occlusion);
+        return;
     }
 
-    bool hasChildren = !node->children.empty();
+    DrawRecord rec;
+    rec.program = program;
+    rec.mesh = mesh.mesh;
+    rec.poolMesh = usePool ? mesh.poolMesh : -1;
+    rec.model = RelativeTo(world, frame.origin);
+    rec.texture = assets.TextureFor(node->texture);
+    const uint32_t depth = ViewDepth(frame, world.Translation());
+    const uint32_t meshKey = rec.poolMesh >= 0 ? (uint32_t)rec.poolMesh : mesh.mesh->vao;
+    frame.queue.Submit(RenderQueue::MakeKey(RenderPass::Opaque, program, meshKey, SceneMaterial(rec.texture, assets), depth),
+                       (uint32_t)frame.drawRecords.size());
+    frame.drawRecords.push_back(rec);
+
+    if (assets.TextureSize(node->texture) > 0) {
+        // Diametro de la esfera que envuelve la caja, proyectado a la distancia del centro. Se supone
+        // que la textura cubre el objeto una vez: un texel por pixel a lo ancho
+        const AABB bounds = AABB::FromOBB(world, mesh.halfExtents);
+        const Vec3 extent = { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+        const Camera& camera = frame.camera;
+        const double distance = std::max(-frame.view.TransformPoint(bounds.Center()).z, camera.nearPlane);
+        const double tanY = std::tan(camera.fovHorizontal * 0.5) / camera.aspectRatio;
+        const float pixels = (float)(extent.Norm() * 0.5 / (distance * tanY) * frame.viewportHeight);
+        float& footprint = frame.textureFootprints[node->texture];
+        footprint = std::max(footprint, pixels);
+    }
+
+    for (GameObject* child : node->children)
+        GatherDraws(child, program, assets, usePool, frame, occlusion);
+}
 
-    //TODO: Si l'objecte no t fills (leaf), fer servir aquest codi:
-    if (!hasChildren)
-    {
-        flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
-        ImGui::TreeNodeEx((void*)node, flags, "%s", node->name.c_str());
-        if (ImGui::IsItemClicked())
-            selectedObject = node;
+// La malla del nodo, no su caja: la caja de una malla que no la llena (p.ej. un octaedro) taparia
+// objetos que se ven
+void GatherOccluders(GameObject* node, const GpuAssets& assets, OcclusionCuller& occlusion) {
+    if (!node) return;
+    if (node->occluder) {
+        const GpuAssets::MeshEntry& mesh = assets.MeshFor(node->mesh);
+        occlusion.AddOccluder(node->GetGlobalMatrix(), mesh.positions.data(), mesh.indices.data(), (int)mesh.indices.size());
     }
-    else
-    {
-        //TODO: Si l'objecte t fills, fer servir aquest codi:
-        bool open = ImGui::TreeNodeEx((void*)node, flags, "%s", node->name.c_str());
-        if (ImGui::IsItemClicked())
-            selectedObject = node;
+    for (GameObject* child : node->children)
+        GatherOccluders(child, assets, occlusion);
+}
 
-        if (open)
-        {
-            for (GameObject* child : node->children)
-                DrawHierarchyNode(child);
-            ImGui::TreePop();
+// Culling GPU: se recorre la escena solo cuando cambia, no cada frame
+void GatherCullInstances(GameObject* node, const GpuAssets& assets, FrameSnapshot& frame) {
+    if (!node) return;
+
+    if (node->light.type != LightType::None) {
+        for (GameObject* child : node->children)
+            GatherCullInstances(child, assets, frame);
+        return;
+    }
+
+    const Affine3& world = node->GetGlobalMatrix();
+    const GpuAssets::MeshEntry& mesh = assets.MeshFor(node->mesh);
+    const AABB bounds = AABB::FromOBB(world, mesh.halfExtents);
+    const Vec3& o = frame.origin;
+
+    GpuCullInstance inst;
+    inst.model = RelativeTo(world, o);
+    inst.boundsMin[0] = (float)(bounds.min.x - o.x); inst.boundsMin[1] = (float)(bounds.min.y - o.y); inst.boundsMin[2] = (float)(bounds.min.z - o.z);
+    inst.boundsMax[0] = (float)(bounds.max.x - o.x); inst.boundsMax[1] = (float)(bounds.max.y - o.y); inst.boundsMax[2] = (float)(bounds.max.z - o.z);
+    frame.cullInstances.push_back(inst);
+    frame.cullMeshIds.push_back((uint32_t)mesh.poolMesh);
+
+    for (GameObject* child : node->children)
+        GatherCullInstances(child, assets, frame);
+}
+
+void GatherLights(GameObject* node, LightClusters& clusters) {
+    if (!node) return;
+    if (node->light.type != LightType::None)
+        clusters.AddLight(node->GetGlobalMatrix(), node->light);
+    for (GameObject* child : node->children)
+        GatherLights(child, clusters);
+}
+
+// Sin UV: texture es la blanca (el programa de escena del camino CPU la muestrea igual)
+void GatherSkinned(SkinnedCharacter& character, SkinningPath path, GLuint program, GLuint texture, FrameSnapshot& frame) {
+    if (character.skeleton.joints.empty()) return;
+
+    DrawRecord rec;
+    rec.program = program;
+    rec.character = &character;
+    rec.path = path;
+    rec.texture = texture;
+    const Vec3 rootPos = character.skeleton.joints[0]->GetGlobalMatrix().Translation();
+    frame.queue.Submit(RenderQueue::MakeKey(RenderPass::Opaque, program, character.mesh.Vao(path), MaterialSkinned, ViewDepth(frame, rootPos)),
+                       (uint32_t)frame.drawRecords.size());
+    frame.drawRecords.push_back(rec);
+}
+
+// Graba los items [begin, end) de la cola ya ordenada. Cada lista empieza sin estado (vuelve a enlazar
+// programa, VAO y paleta), asi que las listas se pueden grabar en paralelo y reproducir seguidas.
+// pool != nullptr: los registros con poolMesh van por el camino indirecto
+void RecordCommands(const FrameSnapshot& frame, std::size_t begin, std::size_t end, const MeshPool* pool, CommandBuffer& out) {
+    const std::vector<RenderItem>& items = frame.queue.Items();
+    const std::vector<DrawRecord>& drawRecords = frame.drawRecords;
+
+    GLuint boundProgram = 0, boundVao = 0, boundTexture = 0, boundPalette = 0;
+    std::size_t i = begin;
+    while (i < end) {
+        const DrawRecord& rec = drawRecords[items[i].index];
+
+        if (rec.program != boundProgram) {
+            out.SetProgram(rec.program);
+            // View y projection son por programa: solo se suben al cambiar
+            out.SetMatrix(UniformSlot::View, frame.renderView);
+            out.SetMatrix(UniformSlot::Projection, frame.proj);
+            boundProgram = rec.program;
+        }
+        if (rec.texture != boundTexture) {
+            out.BindTexture(rec.texture);
+            boundTexture = rec.texture;
+        }
+
+        if (rec.character) {
+            const SkinnedMesh& mesh = rec.character->mesh;
+            GLuint vao = mesh.Vao(rec.path);
+            if (vao != boundVao) {
+                out.BindVertexArray(vao);
+                boundVao = vao;
+            }
+            // Cada personaje tiene su UBO: todas las paletas se suben antes del replay
+            if (rec.path == SkinningPath::GPU && mesh.uboPalette != boundPalette) {
+                out.BindUniformBuffer(SKIN_PALETTE_BINDING, mesh.uboPalette);
+                boundPalette = mesh.uboPalette;
+            }
+            // La paleta ya deja los vertices en espacio mundo relativo a frame.origin
+            out.SetMatrix(UniformSlot::Model, Matrix4x4::Identity());
+            out.SetModel(Affine3f());
+            out.SetColor({ 0.3f, 0.8f, 0.4f });
+            out.DrawIndexed((uint32_t)mesh.indexCount);
+            ++i;
+            continue;
         }
+
+        if (rec.poolMesh >= 0 && pool) {
+            // Mismo pass/programa/material: un comando por malla y un solo glMultiDrawElementsIndirect
+            std::size_t j = i;
+            while (j < end && RenderQueue::SameBatch(items[j].key, items[i].key) && drawRecords[items[j].index].poolMesh >= 0 &&
+                   drawRecords[items[j].index].texture == rec.texture) {
+                const int meshId = drawRecords[items[j].index].poolMesh;
+                std::size_t k = j;
+                while (k < end && RenderQueue::SameBatch(items[k].key, items[i].key) && drawRecords[items[k].index].poolMesh == meshId &&
+                       drawRecords[items[k].index].texture == rec.texture) ++k;
+
+                Affine3f* models = out.IndirectDraw((uint32_t)meshId, (uint32_t)(k - j));
+                for (; j < k; ++j) *models++ = drawRecords[items[j].index].model;
+            }
+
+            if (pool->vao != boundVao) {
+                out.BindVertexArray(pool->vao);
+                boundVao = pool->vao;
+            }
+            out.SetColor({ 1.0f, 0.8f, 0.2f });
+            out.IndirectFlush();
+            i = j;
+            continue;
+        }
+
+        // Claves con el mismo estado seguidas: un solo draw instanciado, ya en orden de delante a atras
+        // La clave trunca VAO y material a 12 bits: se comparan malla y textura antes de juntar
+        std::size_t j = i;
+        while (j < end && RenderQueue::SameState(items[j].key, items[i].key) && !drawRecords[items[j].index].character &&
+               drawRecords[items[j].index].mesh == rec.mesh && drawRecords[items[j].index].texture == rec.texture) ++j;
+
+        Affine3f* models = out.UploadInstances(rec.mesh->instanceVbo, (uint32_t)(j - i));
+        for (std::size_t k = i; k < j; ++k) *models++ = drawRecords[items[k].index].model;
+        if (rec.mesh->vao != boundVao) {
+            out.BindVertexArray(rec.mesh->vao);
+            boundVao = rec.mesh->vao;
+        }
+        // Color simple (puedes variar)
+        out.SetColor({ 1.0f, 0.8f, 0.2f });
+        out.DrawIndexedInstanced((uint32_t)rec.mesh->indexCount, (uint32_t)(j - i));
+        i = j;
     }
 }
 
+void ReplayFrame(const FrameSnapshot& frame, IndirectRenderer* indirect, const MeshPool* pool) {
+    for (const CommandBuffer& commands : frame.commands)
+        ReplayCommands(commands, indirect, pool);
+    glBindVertexArray(0);
+}
+
+// Reparte la cola en trozos iguales, uno por lista y job. Partir un lote solo cuesta un draw mas
+void RecordCommandLists(FrameSnapshot& frame, const MeshPool* pool, JobSystem& jobs) {
+    const std::size_t count = frame.queue.Items().size();
+    const std::size_t minItems = 256; // por debajo, el reparto cuesta mas de lo que ahorra
+    const std::size_t lists = std::max<std::size_t>(1, std::min<std::size_t>(jobs.WorkerCount() + 1, count / minItems));
+
+    frame.commands.resize(lists);
+    jobs.ParallelFor(lists, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t l = first; l < last; ++l) {
+            frame.commands[l].Clear();
+            RecordCommands(frame, count * l / lists, count * (l + 1) / lists, pool, frame.commands[l]);
+        }
+    });
+}
+
 // -----------------------------------------------------------------------------
-// RENDER (TODO)
+// HELPER: Escenas en segundo plano
+// Mientras AssetManager lee y decodifica, la jerarquia ya muestra un nodo vacio con el nombre del
+// fichero; cuando la escena llega sus roots se cuelgan de el (la transformacion del nodo se conserva)
 // -----------------------------------------------------------------------------
-void RenderNode(GameObject* node, GLuint shaderProgram, const Matrix4x4& view, const Matrix4x4& proj, Mesh& mesh) {
-    if (!node) return;
+struct LoadingScene {
+    AssetHandle handle;
+    GameObject* placeholder = nullptr;
+};
+
+void OpenScene(AssetManager& assets, const std::string& path, std::vector<GameObject*>& sceneRoots, std::vector<LoadingScene>& loading) {
+    GameObject* placeholder = new GameObject("Loading " + std::filesystem::path(path).filename().string());
+    sceneRoots.push_back(placeholder);
+    loading.push_back({ assets.LoadScene(path), placeholder });
+}
 
-    Matrix4x4 model = node->GetGlobalMatrix();
+// arrived: escenas subidas este frame (GpuAssets::scenes). Devuelve true si la jerarquia ha cambiado
+bool ResolveScenes(const AssetManager& assets, std::vector<LoadedAsset>& arrived, std::vector<LoadingScene>& loading) {
+    bool changed = false;
+    for (LoadedAsset& scene : arrived) {
+        for (std::size_t i = 0; i < loading.size(); ++i) {
+            if (loading[i].handle.id != scene.handle.id) continue;
+            GameObject* placeholder = loading[i].placeholder;
+            placeholder->name = std::filesystem::path(assets.Path(scene.handle)).stem().string();
+            for (GameObject* root : scene.roots)
+                placeholder->AddChild(root);
+            loading.erase(loading.begin() + i);
+            changed = true;
+            break;
+        }
+    }
+    arrived.clear();
+
+    for (std::size_t i = 0; i < loading.size();) {
+        if (assets.State(loading[i].handle) == AssetState::Failed) {
+            std::cerr << "Scene load failed: " << assets.Error(loading[i].handle) << std::endl;
+            loading[i].placeholder->name = "Failed " + std::filesystem::path(assets.Path(loading[i].handle)).filename().string();
+            loading.erase(loading.begin() + i);
+            changed = true;
+        }
+        else {
+            ++i;
+        }
+    }
+    return changed;
+}
+
+// Arboles que ya no cuelgan de sceneRoots (celdas descargadas): se quitan de la seleccion, el journal y
+// la jerarquia antes de borrarlos. El BVH se reconstruye con el siguiente bvhDirty
+void DestroyDetached(std::vector<GameObject*>& detached, AssetManager& assets) {
+    if (detached.empty()) return;
+    std::unordered_set<const GameObject*> gone;
+    std::vector<GameObject*> stack(detached.begin(), detached.end());
+    while (!stack.empty()) {
+        GameObject* node = stack.back();
+        stack.pop_back();
+        gone.insert(node);
+        selection.Remove(node);
+        hierarchyView.SetExpanded(node, false);
+        stack.insert(stack.end(), node->children.begin(), node->children.end());
+    }
+    journal.Forget(gone);
+    for (GameObject* root : detached)
+        assets.DestroyTree(root);
+    detached.clear();
+}
 
-    GraphicsUtils::UploadMVP(shaderProgram, model, view, proj);
+// Ruta de una malla o textura de AssetManager relativa al directorio donde se escribe la escena
+std::string RelativeAssetPath(const AssetManager& assets, uint32_t id, const std::string& dir) {
+    const std::string path = assets.Path({ id });
+    std::error_code ec;
+    const std::filesystem::path relative = std::filesystem::relative(path, dir, ec);
+    return ec || relative.empty() ? std::filesystem::absolute(path, ec).generic_string() : relative.generic_string();
+}
 
-    // Color simple (puedes variar)
-    GraphicsUtils::UploadColor(shaderProgram, { 1.0f, 0.8f, 0.2f });
+// Mundo de prueba para el streaming: size x size celdas con unos objetos y una luz cada una
+bool GenerateTestWorld(const std::string& dir, int size, double cellSize, AssetManager& assets, std::string& error) {
+    std::vector<GameObject*> roots;
+    for (int cz = 0; cz < size; ++cz) {
+        for (int cx = 0; cx < size; ++cx) {
+            const std::string suffix = std::to_string(cx) + "_" + std::to_string(cz);
+            for (int k = 0; k < 8; ++k) {
+                // Posicion pseudoaleatoria estable dentro de la celda
+                const uint32_t h = (uint32_t)(cx * 73856093) ^ (uint32_t)(cz * 19349663) ^ (uint32_t)(k * 83492791);
+                GameObject* obj = new GameObject("Object" + suffix + "_" + std::to_string(k));
+                obj->transform.position = { (cx + (h % 1000) / 1000.0) * cellSize, 0.5, (cz + ((h >> 10) % 1000) / 1000.0) * cellSize };
+                obj->transform.scale = { 1.0, 1.0 + (h >> 20) % 4, 1.0 };
+                if (k % 2) obj->mesh = assets.LoadMesh("octahedron.obj").id;
+                roots.push_back(obj);
+            }
+            GameObject* light = new GameObject("Light" + suffix);
+            light->light.type = LightType::Point;
+            light->light.range = cellSize * 0.5;
+            const double hue = (cx * size + cz) * 0.7;
+            light->light.color = { 0.5 + 0.5 * std::cos(hue), 0.5 + 0.5 * std::cos(hue + 2.094), 0.5 + 0.5 * std::cos(hue + 4.189) };
+            light->transform.position = { (cx + 0.5) * cellSize, 2.0, (cz + 0.5) * cellSize };
+            roots.push_back(light);
+        }
+    }
 
-    mesh.Draw();
+    const bool ok = WorldPartition::Export(dir, cellSize, roots,
+                                           [&](uint32_t id) { return RelativeAssetPath(assets, id, dir); }, error);
+    for (GameObject* root : roots)
+        assets.DestroyTree(root);
+    return ok;
+}
 
-    for (GameObject* child : node->children)
-        RenderNode(child, shaderProgram, view, proj, mesh);
+// -----------------------------------------------------------------------------
+// HELPER: Modo headless (--headless [--size WxH] [--frames N] [--out DIR] [--raw])
+// Sin ventana visible ni UI: la escena se dibuja en un FBO de tamano fijo, sin VSync, y cada
+// frame se lee con PBOs y se guarda como secuencia PPM (o RGBA crudo)
+// -----------------------------------------------------------------------------
+struct HeadlessOptions {
+    bool enabled = false;
+    int width = 1280, height = 720;
+    int frames = 1;
+    std::string outDir = ".";
+    FrameFormat format = FrameFormat::PPM;
+    // --scene FILE (repetible, tambien con ventana). Headless espera a que esten cargadas
+    std::vector<std::string> scenes;
+    // --world FILE: indice de WorldPartition, se hace streaming alrededor de la camara
+    std::string world;
+};
+
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--headless") options.enabled = true;
+        else if (arg == "--raw") options.format = FrameFormat::Raw;
+        else if (arg == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 || options.width <= 0 || options.height <= 0) {
+                std::cerr << "Invalid --size (expected WxH): " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--frames" && hasValue) {
+            options.frames = std::atoi(argv[++i]);
+            if (options.frames <= 0) {
+                std::cerr << "Invalid --frames: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--out" && hasValue) options.outDir = argv[++i];
+        else if (arg == "--scene" && hasValue) options.scenes.push_back(argv[++i]);
+        else if (arg == "--world" && hasValue) options.world = argv[++i];
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
 }
 
 // -----------------------------------------------------------------------------
 // MAIN (TODO)
 // -----------------------------------------------------------------------------
 int main(int argc, char** argv) {
+    HeadlessOptions headless;
+    if (!ParseHeadlessOptions(argc, argv, headless)) return 1;
+
     // 1. Setup SDL & OpenGL
-    if (!SDL_Init(SDL_INIT_VIDEO)) {
+    bool sdlReady = SDL_Init(SDL_INIT_VIDEO);
+    if (!sdlReady && headless.enabled) {
+        // Servidor sin display: el driver offscreen de SDL crea el contexto con EGL (Mesa llvmpipe)
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        sdlReady = SDL_Init(SDL_INIT_VIDEO);
+    }
+    if (!sdlReady) {
         std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
         return 1;
     }
 
-    // Configuraci de context OpenGL 3.3 Core
+    // Configuraci de context OpenGL Core
+    // Se pide 4.5 (multi-draw indirect, buffers persistentes); si el driver no lo da, 3.3
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 
-    SDL_Window* window = SDL_CreateWindow("Project: Mini-Scene 3D", 1280, 720, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+    SDL_WindowFlags windowFlags = SDL_WINDOW_OPENGL | (headless.enabled ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE);
+    SDL_Window* window = SDL_CreateWindow("Project: Mini-Scene 3D", headless.width, headless.height, windowFlags);
     if (!window) return 1;
 
     SDL_GLContext glContext = SDL_GL_CreateContext(window);
+    if (!glContext) {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+        glContext = SDL_GL_CreateContext(window);
+    }
+    if (!glContext) {
+        std::cerr << "SDL_GL_CreateContext Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
     SDL_GL_MakeCurrent(window, glContext);
-    SDL_GL_SetSwapInterval(1); // VSync
+    SDL_GL_SetSwapInterval(headless.enabled ? 0 : 1); // VSync (headless: sin limite, no se presenta nada)
 
+    // Core profile: sin esto GLEW no carga las extensiones (usa glGetString(GL_EXTENSIONS))
+    glewExperimental = GL_TRUE;
     if (glewInit() != GLEW_OK) return 1;
 
+    // Binarios de programa en shader_cache/: el segundo arranque no compila nada
+    shaderCacheEnabled = ShaderCache::Supported();
+
     glEnable(GL_DEPTH_TEST);
 
     // 2. Setup ImGui
@@ -195,37 +856,266 @@ int main(int argc, char** argv) {
     Mesh cubeMesh;
     cubeMesh.InitCube();
 
+    // Camino indirecto: todas las mallas en un pool y un multi-draw por lote
+    MeshPool meshPool;
+    const int cubePoolMesh = meshPool.AddCube();
+    IndirectRenderer indirectRenderer;
+    const bool indirectSupported = IndirectRenderer::Supported();
+    bool useIndirect = indirectSupported;
+    if (indirectSupported) indirectRenderer.Init(meshPool, 1024, 64);
+
+    // Mallas, texturas y escenas: lectura y decodificacion en hilos propios, subida aqui con un
+    // presupuesto por frame. Lo que no ha llegado se dibuja como el cubo
+    AssetManager assetManager;
+    GpuAssets gpuAssets;
+    gpuAssets.Init(cubeMesh, cubePoolMesh);
+    assetManager.SetGpuTextureFormats(GpuAssets::SupportedTextureFormats());
+    float assetUploadBudgetMs = 2.0f;
+    int textureBudgetMB = (int)(gpuAssets.textureBudgetBytes >> 20);
+    std::vector<LoadingScene> loadingScenes;
+    char scenePath[256] = "level.scene";
+
+    // Mundo por celdas: cada una es una escena de AssetManager que entra y sale con la camara
+    WorldPartition world;
+    std::vector<GameObject*> unloadedCells;
+    char worldPath[256] = "world/world.txt";
+
+    // Culling en compute (GL 4.3): frustum + Hi-Z del frame anterior; la escena se dibuja en sceneTarget
+    // para poder leer su profundidad
+    GpuCuller gpuCuller;
+    RenderTarget sceneTarget;
+    bool gpuCullingSupported = false;
+    if (GpuCuller::Supported()) {
+        GLuint cullProgram = CreateComputeProgram("cull.comp.glsl");
+        GLuint hizProgram = CreateComputeProgram("hiz.comp.glsl");
+        if (cullProgram != 0 && hizProgram != 0) {
+            gpuCuller.Init(cullProgram, hizProgram, meshPool);
+            gpuCullingSupported = true;
+        }
+    }
+    bool useGpuCulling = false;
+
+    // Culling por oclusion en CPU: oclusores marcados en el Inspector, rasterizados en los workers
+    JobSystem jobSystem;
+    OcclusionCuller occlusionCuller;
+    bool useOcclusionCulling = false;
+    Matrix4x4 prevViewProj = Matrix4x4::Identity();
+
+    // Headless: lectura con PBOs y escritura a disco en otro hilo (solo existe en headless)
+    FrameReadback frameReadback;
+    std::unique_ptr<FrameWriter> frameWriter;
+    std::vector<uint8_t> frameData;
+    int renderedFrames = 0;
+    if (headless.enabled) {
+        frameReadback.Init(headless.width, headless.height);
+        frameWriter = std::make_unique<FrameWriter>(headless.outDir, headless.format);
+    }
+
     // TODO: Assegureu-vos de tenir els fitxers vs.glsl i fs.glsl al mateix nivell de l'executable
-    GLuint shaderProgram = CreateShaderProgram("vs.glsl", "fs.glsl");
-    if (shaderProgram == 0) std::cerr << "Warning: Shaders not loaded properly." << std::endl;
+    std::vector<std::pair<GLenum, std::string>> surfaceSources;
+    LoadSources(surfaceShaderFiles, surfaceSources);
+    surfaceShaders.Init(std::move(surfaceSources), shaderCacheEnabled ? &shaderCache : nullptr, SetupSurfaceProgram, RetireProgram);
+
+    // Todas las combinaciones que se pueden elegir en la UI se lanzan ya (o se encolan si el driver no
+    // compila en paralelo); solo se esperan las dos que decide el arranque
+    std::vector<uint32_t> prewarmVariants;
+    for (uint32_t options = 0; options < 8; ++options)
+        for (uint32_t base : { (uint32_t)ShaderInstanced, (uint32_t)ShaderSkinned, (uint32_t)(ShaderSkinned | ShaderDualQuat) })
+            prewarmVariants.push_back(base | ((options & 1) ? ShaderLit : 0u) | ((options & 2) ? ShaderAlphaTest : 0u) |
+                                      ((options & 4) ? ShaderClustered : 0u));
+    surfaceShaders.Prewarm(prewarmVariants);
+    if (surfaceShaders.Get(ShaderInstanced) == 0) std::cerr << "Warning: Shaders not loaded properly." << std::endl;
+    const bool skinnedShaderReady = surfaceShaders.Get(ShaderSkinned) != 0;
+    bool litShading = false;
+    bool alphaTest = false;
+
+    // Luces dinamicas: listas por cluster calculadas en el hilo de simulacion, subidas a buffers de textura
+    LightBuffers lightBuffers;
+    lightBuffers.Init();
+    bool useClusteredLights = false;
+
+    // Recarga en caliente (opcional, desde Camera Settings): el watcher solo existe mientras esta activa
+    if (gpuCullingSupported) {
+        reloadablePrograms.push_back({ { { GL_COMPUTE_SHADER, "cull.comp.glsl" } }, &gpuCuller.cullProgram, nullptr, {}, 0 });
+        reloadablePrograms.push_back({ { { GL_COMPUTE_SHADER, "hiz.comp.glsl" } }, &gpuCuller.hizProgram, nullptr, {}, 0 });
+    }
+    std::unique_ptr<ShaderWatcher> shaderWatcher;
+    bool hotReloadShaders = false;
+
+    // Cada plataforma decide; sin shader de skinning siempre CPU
+    SkinningPath skinningPath = skinnedShaderReady ? ChooseSkinningPath() : SkinningPath::CPU;
+    SkinningBlend skinningBlend = SkinningBlend::Linear;
+    std::vector<SkinnedCharacter*> characters;
 
     // 4. TODO: Preparar escena Inicial
     GameObject* rootObject = new GameObject("Root");
     rootObject->name = "Root";
     std::vector<GameObject*> sceneRoots = { rootObject };
+    for (const std::string& path : headless.scenes)
+        OpenScene(assetManager, path, sceneRoots, loadingScenes);
+    if (!headless.world.empty()) {
+        std::string error;
+        if (!world.Open(headless.world, error)) std::cerr << "World: " << error << std::endl;
+    }
 
     Camera mainCamera;
     mainCamera.transform.position = { 0.0, 2.0, 6.0 };
+    // mainCamera es el estado de simulacion; se dibuja renderCamera, interpolada entre cameraPrevious
+    // y mainCamera (el click del viewport usa tambien la que se ve)
+    Transform cameraPrevious = mainCamera.transform;
+    Camera renderCamera = mainCamera;
+    bool cameraMoving = false;
+
+    // Seleccion desde el viewport: el BVH se pone al dia una vez por frame antes de los eventos, asi el
+    // click solo lanza el rayo. bvhDirty: la estructura ha cambiado (rebuild); bvhRefit: solo transforms
+    SceneBVH sceneBVH;
+    bool bvhDirty = true;
+    bool bvhRefit = false;
+    // Igual para las instancias del culling GPU
+    bool cullerDirty = true;
+    // Esas instancias no se recorren cada frame, asi que no pueden ser relativas a la camara: lo son a
+    // cullOrigin, que se mueve (y se resuben) cuando la camara se aleja mas de CullOriginDrift. A esa
+    // distancia el float aun sobra para la traslacion que queda en la vista
+    Vec3 cullOrigin;
+    const double CullOriginDrift = 1024.0;
 
     //TODO: Inicialitzar la cmera
 
     // 5. Loop Principal
+    // Hilo de simulacion: recorre la escena (matrices globales, culling, skinning, orden de la cola) y
+    // deja el frame en el buffer de atras mientras este hilo envia a GL el de delante
+    FrameSnapshot frames[2];
+    for (FrameSnapshot& frame : frames) {
+        frame.clusters.maxIndices = (std::size_t)LightBuffers::MaxTexels();
+        frame.clusters.maxLights = frame.clusters.maxIndices / 3;
+    }
+    FramePipeline pipeline([&](int buffer) {
+        FrameSnapshot& frame = frames[buffer];
+        frame.view = frame.camera.GetViewMatrix();
+        const Vec3& eye = frame.camera.transform.position;
+        frame.renderView = frame.camera.GetRenderViewMatrix().Multiply(
+            Matrix4x4::Translate({ frame.origin.x - eye.x, frame.origin.y - eye.y, frame.origin.z - eye.z }));
+        frame.proj = frame.camera.GetProjectionMatrix();
+        frame.queue.Clear();
+        frame.drawRecords.clear();
+        frame.skinned.clear();
+        frame.textureFootprints.clear();
+        if (frame.sceneProgram == 0) return;
+
+        if (!frame.useGpuCulling) {
+            if (frame.useOcclusionCulling) {
+                occlusionCuller.Begin(frame.proj.Multiply(frame.view));
+                for (GameObject* root : sceneRoots)
+                    GatherOccluders(root, gpuAssets, occlusionCuller);
+                occlusionCuller.Rasterize(jobSystem);
+            }
+            for (GameObject* root : sceneRoots)
+                GatherDraws(root, frame.sceneProgram, gpuAssets, frame.useIndirect, frame,
+                            frame.useOcclusionCulling ? &occlusionCuller : nullptr);
+        }
+
+        // Sin variante de skinning (p.ej. la de dual quats no compila) se hace en CPU
+        const SkinningPath path = frame.skinnedProgram != 0 ? frame.skinningPath : SkinningPath::CPU;
+        frame.skinned.resize(characters.size());
+        for (std::size_t i = 0; i < characters.size(); ++i) {
+            frame.skinned[i].character = characters[i];
+            frame.skinned[i].path = path;
+            ComputeSkinned(frame.skinned[i], frame.skinningBlend, frame.origin);
+            GatherSkinned(*characters[i], path, path == SkinningPath::GPU ? frame.skinnedProgram : frame.sceneProgram,
+                          gpuAssets.whiteTexture, frame);
+        }
+
+        if (frame.useClusteredLights) {
+            frame.clusters.Begin(frame.origin);
+            for (GameObject* root : sceneRoots)
+                GatherLights(root, frame.clusters);
+            frame.clusters.Build(frame.camera, jobSystem);
+        }
+
+        if (frame.gatherCullInstances) {
+            frame.cullInstances.clear();
+            frame.cullMeshIds.clear();
+            for (GameObject* root : sceneRoots)
+                GatherCullInstances(root, gpuAssets, frame);
+        }
+
+        frame.queue.Sort();
+        RecordCommandLists(frame, frame.useIndirect ? &meshPool : nullptr, jobSystem);
+    });
+    bool usePipelining = true;
+
     bool running = true;
-    lastTicks = SDL_GetTicks();
+    FixedTimestep timestep(SDL_GetPerformanceFrequency());
+    float simulationHz = 60.0f;
+    timestep.Reset(SDL_GetPerformanceCounter());
     while (running) {
 
-        Uint64 currentTicks = SDL_GetTicks();
-        float deltaTime = (currentTicks - lastTicks) / 1000.0f;
-        lastTicks = currentTicks;
+        // Shaders cambiados en disco: la simulacion esta parada, los programas se pueden cambiar
+        if (shaderWatcher) {
+            const std::vector<std::string> changed = shaderWatcher->TakeChanged();
+            if (!changed.empty()) {
+                ReloadPrograms(changed);
+                RequestRedraw();
+            }
+        }
+        // Variantes y programas compilandose (prewarm o recarga): se sigue dibujando hasta que se instalen
+        if (surfaceShaders.Poll() + PollReloadedPrograms() > 0) RequestRedraw();
+
+        // Celdas que entran y salen con la posicion de la camara. Las que salen se descuelgan ya; sus
+        // mallas se liberan en GpuAssets cuando el frame que se esta enviando ya no las usa
+        if (world.IsOpen()) {
+            world.Update(mainCamera.transform.position, assetManager, sceneRoots, unloadedCells);
+            if (!unloadedCells.empty()) {
+                DestroyDetached(unloadedCells, assetManager);
+                bvhDirty = cullerDirty = true;
+                hierarchyView.MarkDirty();
+                RequestRedraw();
+            }
+        }
 
-        Vec3 forward = mainCamera.transform.rotation.Rotate({ 0, 0, -1 });
-        Vec3 right = mainCamera.transform.rotation.Rotate({ 1, 0, 0 });
-        Vec3 up = { 0, 1, 0 };
+        // Assets decodificados: se suben hasta gastar el presupuesto y el resto espera al siguiente frame.
+        // Headless no tiene prisa: espera a todo para que cada imagen salga con la escena completa
+        do {
+            // Una malla nueva cambia la caja y la malla del pool de los nodos que la usan
+            const bool uploaded = gpuAssets.Upload(assetManager, &meshPool, headless.enabled ? 1e9 : assetUploadBudgetMs) > 0;
+            world.Adopt(gpuAssets.scenes, sceneRoots);
+            const bool scenesChanged = ResolveScenes(assetManager, gpuAssets.scenes, loadingScenes);
+            if (uploaded) bvhDirty = cullerDirty = true;
+            // Mallas soltadas RetireFrames despues de descargar su celda: no cuentan como subidas
+            if (gpuAssets.poolChanged) cullerDirty = true;
+            if (uploaded || scenesChanged) {
+                hierarchyView.MarkDirty();
+                RequestRedraw();
+            }
+            if (headless.enabled && assetManager.PendingCount() > 0) SDL_Delay(1);
+        } while (headless.enabled && assetManager.PendingCount() > 0);
+        // Mips segun lo que ocupaba cada textura en el ultimo frame preparado (el culling GPU no recorre
+        // la escena: sus texturas se quedan con los niveles de llegada)
+        gpuAssets.textureBudgetBytes = (std::size_t)textureBudgetMB << 20;
+        if (gpuAssets.StreamTextures(frames[pipeline.Front()].textureFootprints, headless.enabled ? 1e9 : assetUploadBudgetMs) > 0)
+            RequestRedraw();
+        // Sigue dando vueltas mientras haya algo en camino
+        if (assetManager.PendingCount() > 0) RequestRedraw();
+
+        // Nada pendiente: se bloquea hasta el siguiente evento (queda en la cola). El timeout deja
+        // despertar de vez en cuando por si otra parte del programa ha pedido un redibujado
+        if (redrawOnDemand && !headless.enabled && pendingRedraws == 0) {
+            if (!SDL_WaitEventTimeout(nullptr, 250) && pendingRedraws == 0) continue;
+            // El tiempo dormido no se simula
+            timestep.Reset(SDL_GetPerformanceCounter());
+        }
+
+        if (bvhDirty)
+            sceneBVH.Build(sceneRoots, [&](uint32_t mesh) { return gpuAssets.MeshFor(mesh).halfExtents; });
+        else if (bvhRefit)
+            sceneBVH.Refit();
+        bvhDirty = bvhRefit = false;
 
         // --- INPUT ---
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             ImGui_ImplSDL3_ProcessEvent(&event);
+            RequestRedraw();
             if (event.type == SDL_EVENT_QUIT) running = false;
             if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(window)) running = false;
             if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP)
@@ -256,6 +1146,28 @@ int main(int argc, char** argv) {
             {
                 rightMousePressed = false;
             }
+            if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN &&
+                event.button.button == SDL_BUTTON_LEFT && !io.WantCaptureMouse)
+            {
+                int winW, winH;
+                SDL_GetWindowSize(window, &winW, &winH);
+                if (winW > 0 && winH > 0)
+                {
+                    Ray ray = renderCamera.ScreenPointToRay(event.button.x, event.button.y, winW, winH);
+                    RayHit hit;
+                    bool additive = (SDL_GetModState() & (SDL_KMOD_SHIFT | SDL_KMOD_CTRL)) != 0;
+                    if (sceneBVH.Raycast(ray, hit))
+                    {
+                        if (additive) selection.Toggle(hit.object);
+                        else selection.Set(hit.object);
+                        hierarchyView.Reveal(hit.object);
+                    }
+                    else if (!additive)
+                    {
+                        selection.Clear();
+                    }
+                }
+            }
             if (event.type == SDL_EVENT_MOUSE_MOTION && rightMousePressed)
             {
                 int dx = event.motion.x - lastMouseX;
@@ -280,35 +1192,63 @@ int main(int argc, char** argv) {
                 mainCamera.transform.rotation = qYaw * qPitch * mainCamera.transform.rotation;
 
                 mainCamera.transform.rotation = mainCamera.transform.rotation.Normalized();
+                // Mirar con el raton es entrada directa, no simulacion: no se interpola
+                cameraPrevious.rotation = mainCamera.transform.rotation;
             }
         }
 
-        Vec3 movement = { 0, 0, 0 };
+        // --- SIMULACION (paso fijo) ---
+        // Headless: un paso por frame para que la secuencia no dependa de lo rapido que se renderice
+        const int steps = headless.enabled ? 1 : timestep.Advance(SDL_GetPerformanceCounter());
+        const double stepTime = timestep.Step();
+        for (int i = 0; i < steps; ++i)
+        {
+            cameraPrevious = mainCamera.transform;
+            cameraMoving = false;
 
-        if (keyW) movement.z -= 1.0;
-        if (keyS) movement.z += 1.0;
-        if (keyA) movement.x -= 1.0;
-        if (keyD) movement.x += 1.0;
-        if (keyE) movement.y += 1.0;
-        if (keyQ) movement.y -= 1.0;
+            Vec3 movement = { 0, 0, 0 };
 
-        if (movement.Norm() > 0.0)
-        {
-            movement = movement.Normalize();
+            if (keyW) movement.z -= 1.0;
+            if (keyS) movement.z += 1.0;
+            if (keyA) movement.x -= 1.0;
+            if (keyD) movement.x += 1.0;
+            if (keyE) movement.y += 1.0;
+            if (keyQ) movement.y -= 1.0;
+
+            if (movement.Norm() > 0.0)
+            {
+                cameraMoving = true;
+                movement = movement.Normalize();
 
-            // Movimiento en espacio local de la cmara
-            Vec3 worldMove = mainCamera.transform.rotation.Rotate(movement);
+                // Movimiento en espacio local de la cmara
+                Vec3 worldMove = mainCamera.transform.rotation.Rotate(movement);
 
-            mainCamera.transform.position.x += worldMove.x * cameraSpeed * deltaTime;
-            mainCamera.transform.position.y += worldMove.y * cameraSpeed * deltaTime;
-            mainCamera.transform.position.z += worldMove.z * cameraSpeed * deltaTime;
+                mainCamera.transform.position.x += worldMove.x * cameraSpeed * stepTime;
+                mainCamera.transform.position.y += worldMove.y * cameraSpeed * stepTime;
+                mainCamera.transform.position.z += worldMove.z * cameraSpeed * stepTime;
+            }
         }
+        // Hasta que un paso sin movimiento iguale los dos estados la interpolacion sigue avanzando
+        if (cameraMoving) RequestRedraw();
 
         // --- UPDATE UI ---
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL3_NewFrame();
         ImGui::NewFrame();
 
+        // Undo / Redo (Ctrl+Z, Ctrl+Y o Ctrl+Shift+Z)
+        if (!io.WantTextInput)
+        {
+            bool changed = false;
+            if (ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiKey_Z)) changed = journal.Undo();
+            if (ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiKey_Y) ||
+                ImGui::IsKeyChordPressed(ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_Z)) changed = journal.Redo();
+            if (changed) {
+                bvhRefit = cullerDirty = true;
+                RequestRedraw();
+            }
+        }
+
         // UI: Jerarquia
         ImGui::Begin("Hierarchy");
         if (ImGui::Button("Add Object to Root"))
@@ -317,37 +1257,193 @@ int main(int argc, char** argv) {
             GameObject* obj = new GameObject("GameObject");
             obj->name = "GameObject";
             sceneRoots.push_back(obj);
+            bvhDirty = cullerDirty = true;
+            RequestRedraw();
+            hierarchyView.MarkDirty();
+        }
+        LightType addLight = LightType::None;
+        if (ImGui::Button("Add Point Light")) addLight = LightType::Point;
+        ImGui::SameLine();
+        if (ImGui::Button("Add Spot Light")) addLight = LightType::Spot;
+        if (addLight != LightType::None)
+        {
+            GameObject* obj = new GameObject(addLight == LightType::Spot ? "Spot Light" : "Point Light");
+            obj->light.type = addLight;
+            obj->transform.position = { 0.0, 2.0, 0.0 };
+            sceneRoots.push_back(obj);
+            bvhDirty = cullerDirty = true;
+            RequestRedraw();
+            hierarchyView.MarkDirty();
+        }
+        if (ImGui::Button("Add Light Field (256)"))
+        {
+            // 16 x 16 luces puntuales de colores sobre el plano y = 1, separadas 2 unidades
+            GameObject* field = new GameObject("Light Field");
+            for (int i = 0; i < 256; ++i)
+            {
+                GameObject* obj = new GameObject("Light" + std::to_string(i));
+                obj->light.type = LightType::Point;
+                obj->light.range = 3.0;
+                const double hue = i * 0.7;
+                obj->light.color = { 0.5 + 0.5 * std::cos(hue), 0.5 + 0.5 * std::cos(hue + 2.094), 0.5 + 0.5 * std::cos(hue + 4.189) };
+                obj->transform.position = { (i % 16 - 7.5) * 2.0, 1.0, (i / 16 - 7.5) * 2.0 };
+                field->AddChild(obj);
+            }
+            sceneRoots.push_back(field);
+            bvhDirty = cullerDirty = true;
+            RequestRedraw();
+            hierarchyView.MarkDirty();
+        }
+        if (ImGui::Button("Add Skinned Chain"))
+        {
+            characters.push_back(CreateSkinnedChain(sceneRoots, 3));
+            bvhDirty = cullerDirty = true;
+            RequestRedraw();
+            hierarchyView.MarkDirty();
+        }
+        ImGui::InputText("##ScenePath", scenePath, sizeof(scenePath));
+        ImGui::SameLine();
+        if (ImGui::Button("Open Scene") && scenePath[0] != '\0')
+        {
+            OpenScene(assetManager, scenePath, sceneRoots, loadingScenes);
+            bvhDirty = cullerDirty = true;
+            RequestRedraw();
+            hierarchyView.MarkDirty();
+        }
+        ImGui::InputText("##WorldPath", worldPath, sizeof(worldPath));
+        ImGui::SameLine();
+        if (ImGui::Button(world.IsOpen() ? "Close World" : "Open World"))
+        {
+            std::string error;
+            if (world.IsOpen())
+                world.Close(assetManager, sceneRoots, unloadedCells);
+            else if (!world.Open(worldPath, error))
+                std::cerr << "World: " << error << std::endl;
+            DestroyDetached(unloadedCells, assetManager);
+            bvhDirty = cullerDirty = true;
+            RequestRedraw();
+            hierarchyView.MarkDirty();
+        }
+        if (!world.IsOpen())
+        {
+            // Se escriben junto al indice de worldPath; luego Open World los carga por celdas
+            const std::string worldDir = std::filesystem::path(worldPath).parent_path().string();
+            std::string error;
+            if (ImGui::Button("Export Scene as World") &&
+                !WorldPartition::Export(worldDir, 16.0, sceneRoots,
+                                        [&](uint32_t id) { return RelativeAssetPath(assetManager, id, worldDir); }, error))
+                std::cerr << "World: " << error << std::endl;
+            ImGui::SameLine();
+            if (ImGui::Button("Generate Test World (64x64)") && !GenerateTestWorld(worldDir, 64, 16.0, assetManager, error))
+                std::cerr << "World: " << error << std::endl;
         }
+        if (assetManager.PendingCount() > 0)
+            ImGui::TextDisabled("Loading assets: %zu", assetManager.PendingCount());
         ImGui::Separator();
-        for (auto* obj : sceneRoots) DrawHierarchyNode(obj);
+        hierarchyView.Draw(sceneRoots, selection);
         ImGui::End();
 
         // UI: Inspector
         ImGui::Begin("Inspector");
+        GameObject* selectedObject = selection.Primary();
         if (selectedObject) {
-            ImGui::Text("Selected: %s", "TODO: <Nom Objecte>");
+            if (selection.Size() > 1)
+                ImGui::Text("Selected: %s (+%d more)", selectedObject->name.c_str(), (int)selection.Size() - 1);
+            else
+                ImGui::Text("Selected: %s", selectedObject->name.c_str());
             ImGui::Separator();
 
+            // Los widgets muestran el objeto principal; el cambio se aplica como delta a toda la seleccion
+
             // TODO: Agafar la posici del selectedObject
             float pos[3] = { (float)selectedObject->transform.position.x, (float)selectedObject->transform.position.y, (float)selectedObject->transform.position.z };
             if (ImGui::DragFloat3("Position", pos, 0.1f))
             {
                 //TODO: Actualitzar la posici del selectedObject
-                selectedObject->transform.position = { pos[0], pos[1], pos[2] };
+                const Vec3& cur = selectedObject->transform.position;
+                selection.Translate({ pos[0] - cur.x, pos[1] - cur.y, pos[2] - cur.z }, &journal);
+                bvhRefit = cullerDirty = true;
+                RequestRedraw();
             }
+            if (ImGui::IsItemDeactivated()) journal.CloseGroup();
+
             // TODO: Agafar la rotaci del selectedObject
             float rot[3] = { (float)selectedObject->transform.eulerRotation.x, (float)selectedObject->transform.eulerRotation.y, (float)selectedObject->transform.eulerRotation.z };
             if (ImGui::DragFloat3("Rotation (Euler)", rot, 0.5f))
             {
                 // TODO: Actualitzar la rotaci del selectedObject
-                selectedObject->transform.SetEulerRotation({ rot[0], rot[1], rot[2] });
+                const Vec3& cur = selectedObject->transform.eulerRotation;
+                selection.RotateEuler({ rot[0] - cur.x, rot[1] - cur.y, rot[2] - cur.z }, &journal);
+                bvhRefit = cullerDirty = true;
+                RequestRedraw();
             }
+            if (ImGui::IsItemDeactivated()) journal.CloseGroup();
+
             // TODO: Agafar l'escala del selectedObject
             float scl[3] = { (float)selectedObject->transform.scale.x, (float)selectedObject->transform.scale.y, (float)selectedObject->transform.scale.z };
             if (ImGui::DragFloat3("Scale", scl, 0.1f))
             {
                 // TODO: Actualitzar l'escala del selectedObject
-                selectedObject->transform.scale = { scl[0], scl[1], scl[2] };
+                const Vec3& cur = selectedObject->transform.scale;
+                selection.AddScale({ scl[0] - cur.x, scl[1] - cur.y, scl[2] - cur.z }, &journal);
+                bvhRefit = cullerDirty = true;
+                RequestRedraw();
+            }
+            if (ImGui::IsItemDeactivated()) journal.CloseGroup();
+
+            if (ImGui::Checkbox("Occluder", &selectedObject->occluder))
+            {
+                for (GameObject* obj : selection.Items()) obj->occluder = selectedObject->occluder;
+            }
+
+            // Luz: igual que Occluder, el cambio se copia a toda la seleccion
+            Light& light = selectedObject->light;
+            bool lightChanged = false;
+            int lightType = (int)light.type;
+            const char* lightTypes[] = { "None", "Point", "Spot" };
+            if (ImGui::Combo("Light", &lightType, lightTypes, 3))
+            {
+                light.type = (LightType)lightType;
+                lightChanged = true;
+            }
+            if (light.type != LightType::None)
+            {
+                float color[3] = { (float)light.color.x, (float)light.color.y, (float)light.color.z };
+                if (ImGui::ColorEdit3("Light Color", color))
+                {
+                    light.color = { color[0], color[1], color[2] };
+                    lightChanged = true;
+                }
+                float intensity = (float)light.intensity;
+                if (ImGui::DragFloat("Intensity", &intensity, 0.05f, 0.0f, 100.0f))
+                {
+                    light.intensity = intensity;
+                    lightChanged = true;
+                }
+                float range = (float)light.range;
+                if (ImGui::DragFloat("Range", &range, 0.05f, 0.01f, 100.0f))
+                {
+                    light.range = range;
+                    lightChanged = true;
+                }
+                if (light.type == LightType::Spot)
+                {
+                    float inner = (float)(light.innerAngle / DEGTORAD);
+                    float outer = (float)(light.outerAngle / DEGTORAD);
+                    if (ImGui::SliderFloat("Inner Angle", &inner, 0.0f, 90.0f) | ImGui::SliderFloat("Outer Angle", &outer, 1.0f, 90.0f))
+                    {
+                        light.innerAngle = std::min(inner, outer) * DEGTORAD;
+                        light.outerAngle = outer * DEGTORAD;
+                        lightChanged = true;
+                    }
+                }
+            }
+            if (lightChanged)
+            {
+                for (GameObject* obj : selection.Items()) obj->light = light;
+                // Con luz el objeto deja de dibujarse como cubo
+                cullerDirty = true;
+                RequestRedraw();
             }
 
             ImGui::Separator();
@@ -357,6 +1453,10 @@ int main(int argc, char** argv) {
                 GameObject* child = new GameObject("Child");
                 child->name = "Child";
                 selectedObject->AddChild(child);
+                bvhDirty = cullerDirty = true;
+                RequestRedraw();
+                hierarchyView.Reveal(child);
+                hierarchyView.MarkDirty();
             }
         }
         else {
@@ -391,12 +1491,71 @@ int main(int argc, char** argv) {
         {
             // TODO: Actualitzar la posici de la cmera
             mainCamera.transform.position = { cPos[0], cPos[1], cPos[2] };
+            cameraPrevious.position = mainCamera.transform.position;
+        }
+
+        ImGui::Separator();
+        bool gpuSkinning = (skinningPath == SkinningPath::GPU);
+        if (ImGui::Checkbox("GPU Skinning", &gpuSkinning) && skinnedShaderReady)
+            skinningPath = gpuSkinning ? SkinningPath::GPU : SkinningPath::CPU;
+        bool dqSkinning = (skinningBlend == SkinningBlend::DualQuat);
+        if (ImGui::Checkbox("Dual Quaternion Skinning", &dqSkinning))
+            skinningBlend = dqSkinning ? SkinningBlend::DualQuat : SkinningBlend::Linear;
+        if (indirectSupported)
+            ImGui::Checkbox("Multi-Draw Indirect", &useIndirect);
+        else
+            ImGui::TextDisabled("Multi-Draw Indirect: needs GL 4.3 + ARB_buffer_storage");
+        if (gpuCullingSupported) {
+            // El Hi-Z guardado puede ser de hace muchos frames
+            if (ImGui::Checkbox("GPU Culling (frustum + Hi-Z)", &useGpuCulling)) gpuCuller.hiZValid = false;
+        }
+        else {
+            ImGui::TextDisabled("GPU Culling: needs GL 4.3");
+        }
+        ImGui::Checkbox("CPU Occlusion Culling", &useOcclusionCulling);
+        ImGui::Checkbox("Redraw On Demand", &redrawOnDemand);
+        ImGui::Checkbox("Pipelined Update/Render", &usePipelining);
+        if (ImGui::Checkbox("Hot Reload Shaders", &hotReloadShaders)) {
+            shaderWatcher.reset();
+            if (hotReloadShaders) {
+                shaderWatcher = std::make_unique<ShaderWatcher>();
+                for (const auto& file : surfaceShaderFiles)
+                    shaderWatcher->Watch(file.second);
+                for (const ReloadableProgram& reloadable : reloadablePrograms)
+                    for (const auto& file : reloadable.files)
+                        shaderWatcher->Watch(file.second);
+            }
+        }
+        ImGui::TextDisabled(shaderCacheEnabled ? "Shader binary cache: on" : "Shader binary cache: not supported");
+        ImGui::Checkbox("Lit (Lambert)", &litShading);
+        ImGui::Checkbox("Alpha Test", &alphaTest);
+        ImGui::TextDisabled("Shader variants compiled: %u / %u", surfaceShaders.Compiled(), ShaderVariants::Count);
+        ImGui::Checkbox("Clustered Lights", &useClusteredLights);
+        if (useClusteredLights) {
+            const LightClusters& shown = frames[pipeline.Front()].clusters;
+            ImGui::TextDisabled("Lights: %zu, cluster light indices: %zu", shown.Lights().size(), shown.Indices().size());
+        }
+        ImGui::SliderFloat("Asset Upload Budget (ms)", &assetUploadBudgetMs, 0.5f, 16.0f);
+        ImGui::SliderInt("Texture Budget (MB)", &textureBudgetMB, 16, 2048);
+        ImGui::TextDisabled("Textures resident: %.1f MB", gpuAssets.textureBytes / (1024.0 * 1024.0));
+        if (world.IsOpen()) {
+            float loadRadius = (float)world.loadRadius, unloadRadius = (float)world.unloadRadius;
+            if (ImGui::DragFloat("Stream Load Radius", &loadRadius, 1.0f, 1.0f, 1000.0f))
+                world.loadRadius = loadRadius;
+            // La histeresis no puede ser negativa: una celda entraria y saldria en el mismo frame
+            if (ImGui::DragFloat("Stream Unload Radius", &unloadRadius, 1.0f, loadRadius, 2000.0f))
+                world.unloadRadius = std::max(unloadRadius, loadRadius);
+            world.unloadRadius = std::max(world.unloadRadius, world.loadRadius);
+            ImGui::TextDisabled("World cells: %zu loaded, %zu streaming, %zu total", world.LoadedCount(),
+                                world.ActiveCount() - world.LoadedCount(), world.CellCount());
         }
+        if (ImGui::SliderFloat("Simulation Hz", &simulationHz, 10.0f, 240.0f))
+            timestep.SetRate(simulationHz);
         ImGui::End();
 
         // --- RENDER ---
-        int w, h;
-        SDL_GetWindowSize(window, &w, &h);
+        int w = headless.width, h = headless.height;
+        if (!headless.enabled) SDL_GetWindowSize(window, &w, &h);
         glViewport(0, 0, w, h);
         if (h > 0)
         {
@@ -404,34 +1563,148 @@ int main(int argc, char** argv) {
             mainCamera.aspectRatio = (double)w / (double)h;
         }
 
+        // Camara que se ve: interpolada entre los dos ultimos pasos de simulacion
+        renderCamera = mainCamera;
+        renderCamera.transform = Transform::Interpolate(cameraPrevious, mainCamera.transform,
+                                                        headless.enabled ? 1.0 : timestep.Alpha());
+
+        // --- PIPELINE ---
+        // El hilo de simulacion prepara este estado mientras aqui se dibuja el frame anterior; la escena
+        // no se puede tocar hasta el WaitAndSwap. Headless va sincrono: cada imagen es la de su frame
+        const bool pipelined = usePipelining && !headless.enabled;
+        FrameSnapshot& next = frames[pipeline.Back()];
+        next.camera = renderCamera;
+        next.viewportHeight = h;
+        next.useGpuCulling = useGpuCulling;
+        next.useIndirect = useIndirect;
+        next.useOcclusionCulling = useOcclusionCulling;
+        next.useClusteredLights = useClusteredLights;
+        const Vec3& eye = renderCamera.transform.position;
+        if (useGpuCulling && Vec3{ eye.x - cullOrigin.x, eye.y - cullOrigin.y, eye.z - cullOrigin.z }.Norm() > CullOriginDrift)
+            cullerDirty = true;
+        next.gatherCullInstances = useGpuCulling && cullerDirty;
+        if (next.gatherCullInstances) {
+            cullerDirty = false;
+            cullOrigin = eye;
+        }
+        next.origin = useGpuCulling ? cullOrigin : eye;
+        next.skinningPath = skinningPath;
+        next.skinningBlend = skinningBlend;
+        // Variante por mascara: un indice en un array (compila aqui solo si no estaba precompilada)
+        const uint32_t surfaceOptions = (litShading ? ShaderLit : 0u) | (alphaTest ? ShaderAlphaTest : 0u) |
+                                        (useClusteredLights ? ShaderClustered : 0u);
+        next.sceneProgram = surfaceShaders.Get(ShaderInstanced | surfaceOptions);
+        next.skinnedProgram = 0;
+        if (skinningPath == SkinningPath::GPU)
+            next.skinnedProgram = surfaceShaders.Get(ShaderSkinned | surfaceOptions |
+                                                     (skinningBlend == SkinningBlend::DualQuat ? ShaderDualQuat : 0u));
+        pipeline.Kick();
+        if (!pipelined) pipeline.WaitAndSwap();
+        const FrameSnapshot& frame = frames[pipeline.Front()];
+
+        // El culling GPU necesita la profundidad en textura y el modo headless lee el color:
+        // los dos dibujan en sceneTarget
+        const bool drawToTarget = frame.useGpuCulling || headless.enabled;
+        if (drawToTarget) {
+            if (sceneTarget.Resize(w, h)) gpuCuller.hiZValid = false;
+            sceneTarget.Bind();
+        }
+
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        if (shaderProgram != 0) {
-            glUseProgram(shaderProgram);
-
-            // TODO: Clculs de Cmera (View i Projection)
-            Matrix4x4 view = mainCamera.GetViewMatrix();
-            Matrix4x4 proj = mainCamera.GetProjectionMatrix();
-
+        if (frame.sceneProgram != 0) {
             // TODO: Recorregut de l'escena i renderitzat (RenderNode)
-            for (GameObject* root : sceneRoots)
-                RenderNode(root, shaderProgram, view, proj, cubeMesh);
+            // Aqui solo GL: el recorrido de la escena ya esta hecho en frame
+            for (const SkinnedFrame& skinned : frame.skinned)
+                UploadSkinned(skinned);
+            if (frame.useClusteredLights)
+                lightBuffers.Upload(frame.clusters, w, h);
+
+            if (frame.useGpuCulling) {
+                if (frame.gatherCullInstances)
+                    gpuCuller.Upload(meshPool, frame.cullInstances, frame.cullMeshIds);
+
+                // prevViewProj se guarda en mundo (double) y se pasa al origen de este frame, que puede
+                // haber cambiado desde que se genero el Hi-Z
+                const Matrix4x4 viewProj = frame.proj.Multiply(frame.view);
+                gpuCuller.Cull(frame.proj.Multiply(frame.renderView), prevViewProj.Multiply(Matrix4x4::Translate(frame.origin)));
+
+                glUseProgram(frame.sceneProgram);
+                GraphicsUtils::UploadMatrix4(frame.sceneProgram, "u_View", frame.renderView);
+                GraphicsUtils::UploadMatrix4(frame.sceneProgram, "u_Projection", frame.proj);
+                GraphicsUtils::UploadColor(frame.sceneProgram, { 1.0f, 0.8f, 0.2f });
+                // Un solo multi-draw para toda la escena: sin textura por objeto
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, gpuAssets.whiteTexture);
+                gpuCuller.Draw();
+
+                // Solo quedan los personajes con skinning
+                ReplayFrame(frame, nullptr, nullptr);
+
+                gpuCuller.BuildHiZ(sceneTarget.depth, sceneTarget.width, sceneTarget.height);
+                prevViewProj = viewProj;
+            }
+            else if (frame.useIndirect) {
+                // Cota superior: un comando por registro
+                const uint32_t records = (uint32_t)frame.drawRecords.size();
+                indirectRenderer.BeginFrame(meshPool, records, records);
+                ReplayFrame(frame, &indirectRenderer, &meshPool);
+                indirectRenderer.EndFrame();
+            }
+            else {
+                ReplayFrame(frame, nullptr, nullptr);
+            }
         }
+        if (pipelined) pipeline.WaitAndSwap();
+        CollectRetiredPrograms();
 
         ImGui::Render();
+        if (headless.enabled) {
+            if (frameReadback.Capture(sceneTarget.fbo, frameData))
+                frameWriter->Submit(std::move(frameData), w, h);
+            if (++renderedFrames >= headless.frames) running = false;
+            continue;
+        }
+
+        if (drawToTarget) sceneTarget.BlitToDefault();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         SDL_GL_SwapWindow(window);
+        if (pendingRedraws > 0) --pendingRedraws;
+    }
+
+    int exitCode = 0;
+    if (headless.enabled) {
+        if (frameReadback.Finish(frameData))
+            frameWriter->Submit(std::move(frameData), headless.width, headless.height);
+        frameReadback.Shutdown();
+        frameWriter->Close();
+        if (!frameWriter->Error().empty()) {
+            std::cerr << frameWriter->Error() << std::endl;
+            exitCode = 1;
+        }
+        std::cout << "Headless: " << frameWriter->Written() << " frames written to " << headless.outDir << std::endl;
     }
 
     // Cleanup
+    if (indirectSupported) indirectRenderer.Shutdown();
+    if (gpuCullingSupported) {
+        glDeleteProgram(gpuCuller.cullProgram);
+        glDeleteProgram(gpuCuller.hizProgram);
+        gpuCuller.Shutdown();
+    }
+    sceneTarget.Release();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL3_Shutdown();
     ImGui::DestroyContext();
-    glDeleteProgram(shaderProgram);
+    surfaceShaders.Release();
+    for (ReloadableProgram& reloadable : reloadablePrograms) reloadable.pending.Abort();
+    lightBuffers.Shutdown();
+    gpuAssets.Shutdown();
+    for (const auto& retired : retiredPrograms) glDeleteProgram(retired.first);
     SDL_GL_DestroyContext(glContext);
     SDL_DestroyWindow(window);
     SDL_Quit();
 
-    return 0;
+    return exitCode;
 }
\ No newline at end of file
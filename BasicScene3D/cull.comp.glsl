@@ -0,0 +1,81 @@
+#version 430
+layout (local_size_x = 64) in;
+
+struct DrawCommand
+{
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+// GpuCullInstance: 3 filas de la global + min + max del AABB mundo
+layout (std430, binding = 0) readonly buffer Instances { vec4 u_Instances[]; };
+// Affine3f por instancia visible, en la region de su malla
+layout (std430, binding = 1) writeonly buffer Visible { vec4 u_Visible[]; };
+layout (std430, binding = 2) buffer Commands { DrawCommand u_Commands[]; };
+layout (std430, binding = 3) readonly buffer MeshIds { uint u_MeshIds[]; };
+
+uniform uint u_Count;
+uniform vec4 u_Planes[6];
+uniform mat4 u_PrevViewProj;
+uniform sampler2D u_HiZ;
+uniform int u_UseHiZ;
+uniform vec2 u_HiZSize;
+uniform int u_HiZLevels;
+
+bool InsideFrustum(vec3 c, vec3 e)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        vec4 p = u_Planes[i];
+        if (dot(p.xyz, c) + p.w + dot(abs(p.xyz), e) < 0.0) return false;
+    }
+    return true;
+}
+
+// Rectangulo en pantalla y profundidad mas cercana de la caja en el frame anterior;
+// se compara con el maximo del Hi-Z en el nivel donde el rectangulo cubre como mucho 2x2 texels
+bool PassesHiZ(vec3 bmin, vec3 bmax)
+{
+    vec2 lo = vec2(1.0), hi = vec2(0.0);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; ++i)
+    {
+        vec3 c = vec3((i & 1) != 0 ? bmax.x : bmin.x, (i & 2) != 0 ? bmax.y : bmin.y, (i & 4) != 0 ? bmax.z : bmin.z);
+        vec4 h = u_PrevViewProj * vec4(c, 1.0);
+        if (h.w <= 0.0) return true; // cruza el plano de la camara
+        vec3 ndc = h.xyz / h.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        lo = min(lo, uv);
+        hi = max(hi, uv);
+        nearest = min(nearest, ndc.z * 0.5 + 0.5);
+    }
+
+    lo = clamp(lo, 0.0, 1.0);
+    hi = clamp(hi, 0.0, 1.0);
+    vec2 size = (hi - lo) * u_HiZSize;
+    float level = min(ceil(log2(max(max(size.x, size.y), 1.0))), float(u_HiZLevels - 1));
+
+    float d = max(max(textureLod(u_HiZ, lo, level).r, textureLod(u_HiZ, vec2(hi.x, lo.y), level).r),
+                  max(textureLod(u_HiZ, vec2(lo.x, hi.y), level).r, textureLod(u_HiZ, hi, level).r));
+    return nearest <= d;
+}
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_Count) return;
+
+    vec3 bmin = u_Instances[i * 5u + 3u].xyz;
+    vec3 bmax = u_Instances[i * 5u + 4u].xyz;
+    if (!InsideFrustum((bmin + bmax) * 0.5, (bmax - bmin) * 0.5)) return;
+    if (u_UseHiZ == 1 && !PassesHiZ(bmin, bmax)) return;
+
+    uint mesh = u_MeshIds[i];
+    uint slot = u_Commands[mesh].baseInstance + atomicAdd(u_Commands[mesh].instanceCount, 1u);
+    u_Visible[slot * 3u + 0u] = u_Instances[i * 5u + 0u];
+    u_Visible[slot * 3u + 1u] = u_Instances[i * 5u + 1u];
+    u_Visible[slot * 3u + 2u] = u_Instances[i * 5u + 2u];
+}
\ No newline at end of file
@@ -1,7 +1,89 @@
 #version 330 core
+// Variantes: LIT (luz direccional), CLUSTERED (luces puntuales y focos por clusters) y ALPHA_TEST
 out vec4 FragColor;
 uniform vec3 u_Color; // Podem passar un color per objecte
+
+#ifdef INSTANCED
+in vec2 v_UV;
+uniform sampler2D u_Texture; // unidad 0; blanca si el objeto no tiene textura
+#endif
+
+#if defined(LIT) || defined(CLUSTERED)
+#define SHADED
+in vec3 v_WorldPos;
+in vec3 v_Normal;
+#endif
+
+#ifdef LIT
+uniform vec3 u_LightDir = vec3(-0.4, -1.0, -0.3); // direccion en la que viaja la luz, en mundo
+#endif
+
+#ifdef CLUSTERED
+// Listas de LightClusters (LightBuffers): 3 texels por luz, (offset, cuenta) por cluster e indices
+layout (std140) uniform ClusterParams
+{
+    uvec4 u_ClusterDims;  // tiles x, tiles y, slices, luces
+    vec4 u_ClusterScale;  // tile = gl_FragCoord.xy * xy; slice = log(profundidad) * z + w
+};
+uniform samplerBuffer u_Lights;
+uniform usamplerBuffer u_ClusterGrid;
+uniform usamplerBuffer u_LightIndices;
+in float v_ViewDepth;
+
+vec3 ClusteredLighting(vec3 P, vec3 N)
+{
+    uvec2 tile = min(uvec2(gl_FragCoord.xy * u_ClusterScale.xy), u_ClusterDims.xy - 1u);
+    float slice = clamp(log(v_ViewDepth) * u_ClusterScale.z + u_ClusterScale.w, 0.0, float(u_ClusterDims.z - 1u));
+    int cluster = int(tile.x + u_ClusterDims.x * (tile.y + u_ClusterDims.y * uint(slice)));
+    uvec2 list = texelFetch(u_ClusterGrid, cluster).xy;
+
+    vec3 sum = vec3(0.0);
+    for (uint k = 0u; k < list.y; ++k)
+    {
+        int light = int(texelFetch(u_LightIndices, int(list.x + k)).r) * 3;
+        vec4 positionRange = texelFetch(u_Lights, light);
+        vec4 colorInner = texelFetch(u_Lights, light + 1);
+        vec4 directionOuter = texelFetch(u_Lights, light + 2);
+
+        vec3 L = positionRange.xyz - P;
+        float dist = length(L);
+        L /= max(dist, 1e-4);
+        // 1/d^2 que se anula suavemente en el alcance
+        float fade = clamp(1.0 - pow(dist / positionRange.w, 4.0), 0.0, 1.0);
+        float attenuation = fade * fade / (dist * dist + 1.0);
+        float cone = smoothstep(directionOuter.w, colorInner.w, dot(-L, directionOuter.xyz));
+        sum += colorInner.rgb * (max(dot(N, L), 0.0) * attenuation * cone);
+    }
+    return sum;
+}
+#endif
+
+#ifdef ALPHA_TEST
+uniform float u_Alpha = 1.0;
+uniform float u_AlphaCutoff = 0.5;
+#endif
+
 void main()
 {
-    FragColor = vec4(u_Color, 1.0);
+    vec4 albedo = vec4(1.0);
+#ifdef INSTANCED
+    albedo = texture(u_Texture, v_UV);
+#endif
+#ifdef ALPHA_TEST
+    if (u_Alpha * albedo.a < u_AlphaCutoff) discard;
+#endif
+
+    vec3 color = u_Color * albedo.rgb;
+#ifdef SHADED
+    vec3 n = normalize(v_Normal);
+    vec3 lighting = vec3(0.25); // ambiente
+#ifdef LIT
+    lighting += 0.75 * max(dot(n, -normalize(u_LightDir)), 0.0);
+#endif
+#ifdef CLUSTERED
+    lighting += ClusteredLighting(v_WorldPos, n);
+#endif
+    color *= lighting;
+#endif
+    FragColor = vec4(color, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 430
+layout (local_size_x = 8, local_size_y = 8) in;
+
+// Nivel 0: copia de la profundidad. Resto: maximo de los texels del nivel anterior que cubre cada texel
+layout (r32f, binding = 0) uniform readonly image2D u_Src;
+layout (r32f, binding = 1) uniform writeonly image2D u_Dst;
+uniform sampler2D u_Depth;
+uniform int u_FirstLevel;
+
+void main()
+{
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 dstSize = imageSize(u_Dst);
+    if (any(greaterThanEqual(p, dstSize))) return;
+
+    if (u_FirstLevel == 1)
+    {
+        imageStore(u_Dst, p, vec4(texelFetch(u_Depth, p, 0).r));
+        return;
+    }
+
+    ivec2 srcSize = imageSize(u_Src);
+    ivec2 s = p * 2;
+    // Con tamano impar la ultima fila/columna tambien cubre el texel sobrante
+    ivec2 extra = ivec2(p.x == dstSize.x - 1 && (srcSize.x & 1) == 1 ? 1 : 0,
+                        p.y == dstSize.y - 1 && (srcSize.y & 1) == 1 ? 1 : 0);
+
+    float d = 0.0;
+    for (int y = 0; y <= 1 + extra.y; ++y)
+        for (int x = 0; x <= 1 + extra.x; ++x)
+            d = max(d, imageLoad(u_Src, min(s + ivec2(x, y), srcSize - 1)).r);
+
+    imageStore(u_Dst, p, vec4(d));
+}
\ No newline at end of file
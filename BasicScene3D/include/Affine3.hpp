@@ -0,0 +1,170 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include <cassert>
+
+// Transformacion afin 3x4 row-major [A | t]; la fila (0 0 0 1) es implicita.
+// Todas las transforms de la escena son afines: multiplicar e invertir asi
+// evita la fila constante de Matrix4x4 y la comprobacion IsAffine()
+struct Affine3
+{
+    double m[12] = { 1, 0, 0, 0,
+                     0, 1, 0, 0,
+                     0, 0, 1, 0 };
+
+    constexpr double& At(std::size_t i, std::size_t j) { return m[i * 4 + j]; }
+    constexpr double  At(std::size_t i, std::size_t j) const { return m[i * 4 + j]; }
+
+    static constexpr Affine3 Identity() { return {}; }
+
+    static constexpr Affine3 Translate(const Vec3& t)
+    {
+        Affine3 A;
+        A.At(0, 3) = t.x; A.At(1, 3) = t.y; A.At(2, 3) = t.z;
+        return A;
+    }
+    static constexpr Affine3 Scale(const Vec3& s)
+    {
+        Affine3 A;
+        A.At(0, 0) = s.x; A.At(1, 1) = s.y; A.At(2, 2) = s.z;
+        return A;
+    }
+    static constexpr Affine3 FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s)
+    {
+        Affine3 A;
+        for (int i = 0; i < 3; ++i)
+        {
+            A.At(i, 0) = R.At(i, 0) * s.x;
+            A.At(i, 1) = R.At(i, 1) * s.y;
+            A.At(i, 2) = R.At(i, 2) * s.z;
+        }
+        A.At(0, 3) = t.x; A.At(1, 3) = t.y; A.At(2, 3) = t.z;
+        return A;
+    }
+    static Affine3 FromTRS(const Vec3& t, const Quat& q, const Vec3& s)
+    {
+        return FromTRS(t, q.ToMatrix3x3Unchecked(), s);
+    }
+
+    // Conversiones explicitas: solo hace falta Matrix4x4 donde entra la proyeccion
+    static constexpr Affine3 FromMatrix4x4(const Matrix4x4& M)
+    {
+        assert(M.IsAffine() && "Affine3::FromMatrix4x4: matrix is not affine");
+        Affine3 A;
+        for (int k = 0; k < 12; ++k) A.m[k] = M.m[k];
+        return A;
+    }
+    constexpr Matrix4x4 ToMatrix4x4() const
+    {
+        Matrix4x4 M;
+        for (int k = 0; k < 12; ++k) M.m[k] = m[k];
+        M.At(3, 3) = 1;
+        return M;
+    }
+
+    constexpr Matrix3x3 Linear() const
+    {
+        Matrix3x3 L;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                L.At(i, j) = At(i, j);
+        return L;
+    }
+    constexpr Vec3 Translation() const { return { At(0, 3), At(1, 3), At(2, 3) }; }
+
+    // 36 mul + 27 add (Matrix4x4::Multiply: 64 mul + 48 add)
+    constexpr Affine3 Multiply(const Affine3& B) const
+    {
+        Affine3 C;
+        for (int i = 0; i < 3; ++i)
+        {
+            const double a0 = At(i, 0), a1 = At(i, 1), a2 = At(i, 2);
+            C.At(i, 0) = a0 * B.At(0, 0) + a1 * B.At(1, 0) + a2 * B.At(2, 0);
+            C.At(i, 1) = a0 * B.At(0, 1) + a1 * B.At(1, 1) + a2 * B.At(2, 1);
+            C.At(i, 2) = a0 * B.At(0, 2) + a1 * B.At(1, 2) + a2 * B.At(2, 2);
+            C.At(i, 3) = a0 * B.At(0, 3) + a1 * B.At(1, 3) + a2 * B.At(2, 3) + At(i, 3);
+        }
+        return C;
+    }
+    constexpr Affine3 operator*(const Affine3& B) const { return Multiply(B); }
+
+    constexpr Vec3 TransformPoint(const Vec3& p) const
+    {
+        return {
+            At(0, 0) * p.x + At(0, 1) * p.y + At(0, 2) * p.z + At(0, 3),
+            At(1, 0) * p.x + At(1, 1) * p.y + At(1, 2) * p.z + At(1, 3),
+            At(2, 0) * p.x + At(2, 1) * p.y + At(2, 2) * p.z + At(2, 3)
+        };
+    }
+    constexpr Vec3 TransformVector(const Vec3& v) const
+    {
+        return {
+            At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z,
+            At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z,
+            At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z
+        };
+    }
+
+    constexpr double Det() const
+    {
+        return At(0, 0) * (At(1, 1) * At(2, 2) - At(1, 2) * At(2, 1))
+             - At(0, 1) * (At(1, 0) * At(2, 2) - At(1, 2) * At(2, 0))
+             + At(0, 2) * (At(1, 0) * At(2, 1) - At(1, 1) * At(2, 0));
+    }
+
+    // Inversa de cualquier afin no singular: A^-1 = adj(A) / det, t' = -A^-1 t.
+    // Sin ramas; det != 0 es precondicion (assert en Debug)
+    constexpr Affine3 Inverse() const
+    {
+        const double a = At(0, 0), b = At(0, 1), c = At(0, 2);
+        const double d = At(1, 0), e = At(1, 1), f = At(1, 2);
+        const double g = At(2, 0), h = At(2, 1), i = At(2, 2);
+
+        const double A0 = e * i - f * h, A1 = c * h - b * i, A2 = b * f - c * e;
+        const double det = a * A0 + d * A1 + g * A2;
+        assert(det != 0.0 && "Affine3::Inverse: singular matrix");
+        const double inv = 1.0 / det;
+
+        Affine3 R;
+        R.At(0, 0) = A0 * inv;              R.At(0, 1) = A1 * inv;              R.At(0, 2) = A2 * inv;
+        R.At(1, 0) = (f * g - d * i) * inv; R.At(1, 1) = (a * i - c * g) * inv; R.At(1, 2) = (c * d - a * f) * inv;
+        R.At(2, 0) = (d * h - e * g) * inv; R.At(2, 1) = (b * g - a * h) * inv; R.At(2, 2) = (a * e - b * d) * inv;
+
+        const Vec3 t = Translation();
+        const Vec3 ti = R.TransformVector(t);
+        R.At(0, 3) = -ti.x; R.At(1, 3) = -ti.y; R.At(2, 3) = -ti.z;
+        return R;
+    }
+
+    // Solo rotacion + traslacion (p.ej. camara): la inversa de R es R^T
+    constexpr Affine3 InverseRigid() const
+    {
+        Affine3 R;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                R.At(i, j) = At(j, i);
+        const Vec3 ti = R.TransformVector(Translation());
+        R.At(0, 3) = -ti.x; R.At(1, 3) = -ti.y; R.At(2, 3) = -ti.z;
+        return R;
+    }
+};
+
+// Copia en float para la GPU (48 bytes frente a 64 de una mat4): se sube tal cual
+// como atributo de instancia mat3x4, cada fila ocupa una location
+struct Affine3f
+{
+    float m[12] = { 1, 0, 0, 0,
+                    0, 1, 0, 0,
+                    0, 0, 1, 0 };
+
+    constexpr Affine3f() = default;
+    explicit constexpr Affine3f(const Affine3& A)
+    {
+        for (int k = 0; k < 12; ++k) m[k] = static_cast<float>(A.m[k]);
+    }
+};
+static_assert(sizeof(Affine3f) == 48);
+
+// Comprobaciones en tiempo de compilacion de que la libreria basica se pliega
+static_assert(Matrix4x4::Translate({ 1, 2, 3 }).Multiply(Matrix4x4::Scale({ 2, 2, 2 })).At(0, 3) == 1.0);
+static_assert(Affine3::Translate({ 1, 2, 3 }).Multiply(Affine3::Scale({ 2, 4, 8 })).Inverse().At(1, 1) == 0.25);
+static_assert(Affine3::Scale({ 2, 2, 2 }).Inverse().TransformPoint({ 2, 4, 6 }).z == 3.0);
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include "GameObject.hpp"
+#include "TextureCodec.hpp"
+
+// Datos ya decodificados en CPU; el hilo de GL los sube con GpuAssets
+struct MeshData
+{
+    std::vector<float> positions;      // 3 floats por vertice
+    std::vector<float> normals;        // 3 floats por vertice
+    std::vector<float> uvs;            // 2 floats por vertice; t = 0 es la fila de arriba de la imagen
+    std::vector<unsigned int> indices; // triangulos
+    Vec3 halfExtents;                  // caja centrada en el origen que contiene la malla (culling)
+};
+
+enum class AssetType { Mesh, Texture, Scene };
+// Unloaded: soltado con Release (si se vuelve a pedir se recarga con el mismo id)
+enum class AssetState { Pending, Ready, Failed, Unloaded };
+
+// id 0 = ninguno. El handle existe desde la peticion: mientras el asset esta Pending el que dibuja usa
+// un sustituto (cubo unidad, textura blanca) y cuando se sube el mismo id pasa a resolver al asset real
+struct AssetHandle
+{
+    uint32_t id = 0;
+    bool Valid() const { return id != 0; }
+};
+
+// Asset listo para subir. En una escena los nodos estan creados pero sin colgar de nadie: el que la
+// recoge adopta roots. GameObject::mesh de sus nodos ya apunta a mallas pedidas a este AssetManager
+struct LoadedAsset
+{
+    AssetHandle handle;
+    uint32_t generation = 0; // PopDecoded descarta lo de peticiones ya soltadas
+    AssetType type = AssetType::Mesh;
+    MeshData mesh;
+    ImageData image;
+    std::vector<GameObject*> roots;
+};
+
+// Carga en segundo plano: un hilo lee ficheros y varios decodifican (OBJ, KTX2, PPM P6 y escenas de texto).
+// Las peticiones no bloquean; el hilo de GL saca lo decodificado con PopDecoded con el presupuesto que
+// quiera por frame. Pedir dos veces la misma malla o textura devuelve el mismo handle y suma una
+// referencia; cada peticion de escena es una copia nueva. Release resta una: a cero, lo que no ha
+// llegado se descarta y lo que ya estaba en GL sale por TakeEvicted para que el hilo de GL lo borre
+struct AssetManager
+{
+    explicit AssetManager(unsigned decodeThreads = 2);
+    ~AssetManager();
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    AssetHandle LoadMesh(const std::string& path);
+    AssetHandle LoadTexture(const std::string& path);
+    AssetHandle LoadScene(const std::string& path);
+
+    void Release(AssetHandle handle);
+
+    // Formatos de textura que la GPU lee comprimidos (mascara de TextureCodec::Bit). Las texturas que
+    // se decodifiquen despues pasan el resto a RGBA8 en los hilos de decodificacion
+    void SetGpuTextureFormats(uint32_t formats);
+
+    // Borra un arbol de nodos cargado (escena o celda) soltando la malla y la textura de cada nodo
+    void DestroyTree(GameObject* root);
+
+    // Mallas y texturas soltadas desde la ultima llamada que tenian recursos de GL
+    std::vector<AssetHandle> TakeEvicted();
+
+    AssetState State(AssetHandle handle) const;
+    std::string Error(AssetHandle handle) const;
+    std::string Path(AssetHandle handle) const;
+
+    // Peticiones aun sin subir (en cola, leyendose, decodificando o esperando a PopDecoded)
+    std::size_t PendingCount() const;
+
+    // Siguiente asset decodificado en orden de llegada; false si no hay ninguno
+    bool PopDecoded(LoadedAsset& out);
+
+    // Las llama el que sube: Ready cuando los recursos de GL existen, Failed si la subida falla.
+    // MarkReady devuelve false si el asset se solto mientras se subia: el que sube lo borra ya
+    bool MarkReady(const LoadedAsset& asset);
+    void MarkFailed(const LoadedAsset& asset, const std::string& error);
+
+    // Formato de escena: una linea por nodo, los padres antes que los hijos ('#' es comentario)
+    //   node <padre> <px py pz> <rx ry rz> <sx sy sz> <malla | -> <nombre>
+    //   light <point | spot> <r g b> <intensidad> <alcance> [<interior> <exterior>]   (luz del ultimo nodo)
+    //   occluder                                               (el ultimo nodo es oclusor)
+    //   texture <ruta>                                         (textura del ultimo nodo)
+    // padre es el indice del nodo (desde 0) o -1; la rotacion en radianes como eulerRotation; las
+    // rutas de malla y textura son relativas al fichero de la escena
+    static bool ParseScene(const std::string& text, const std::string& baseDir, AssetManager* meshes,
+                           std::vector<GameObject*>& roots, std::string& error);
+    // Inverso de ParseScene; assetPath da la ruta (ya relativa a la escena) de cada id de malla o textura != 0
+    static std::string SerializeScene(const std::vector<GameObject*>& roots, const std::function<std::string(uint32_t)>& assetPath);
+    static bool ParseObj(const std::string& text, MeshData& out, std::string& error);
+    // Un solo nivel RGBA8
+    static bool ParsePpm(const std::string& bytes, ImageData& out, std::string& error);
+    // KTX2 o PPM con la cadena de mips completa; lo comprimido que no este en gpuFormats sale en RGBA8
+    static bool ParseTexture(const std::string& bytes, uint32_t gpuFormats, ImageData& out, std::string& error);
+
+private:
+    struct Entry
+    {
+        AssetType type;
+        std::string path;
+        AssetState state = AssetState::Pending;
+        std::string error;
+        uint32_t refs = 1;
+        uint32_t generation = 0;
+    };
+
+    // Ficheros leidos esperando decodificador: limita la memoria si el disco va mas rapido
+    static constexpr std::size_t MaxReadAhead = 8;
+
+    struct Job
+    {
+        uint32_t id;
+        uint32_t generation;
+        AssetType type;
+        std::string path;
+        std::string bytes;
+    };
+
+    AssetHandle Request(AssetType type, const std::string& path);
+    void ReadLoop();
+    void DecodeLoop();
+    void Queue(uint32_t id);
+    void Fail(uint32_t id, uint32_t generation, const std::string& error);
+    void ReleaseLocked(uint32_t id);
+
+    mutable std::mutex mutex;
+    std::condition_variable readWake;
+    std::condition_variable decodeWake;
+    std::vector<Entry> entries; // por id; la 0 no se usa
+    std::unordered_map<std::string, uint32_t> byPath;
+    std::deque<Job> toRead;
+    std::deque<Job> toDecode;
+    std::deque<LoadedAsset> decoded;
+    std::vector<AssetHandle> evicted;
+    std::size_t pending = 0;
+    uint32_t gpuTextureFormats = TextureCodec::Bit(TextureFormat::RGBA8);
+    bool stopping = false;
+
+    std::thread reader;
+    std::vector<std::thread> decoders;
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Transform.hpp"
+#include "Ray.hpp"
 #include <cmath>
 
 #ifndef DEGTORAD
@@ -18,7 +19,13 @@ struct Camera
 
     Matrix4x4 GetViewMatrix() const;
 
+    // Solo la rotacion: para dibujar con posiciones ya relativas a la camara (restadas en double).
+    // Lejos del origen la traslacion de GetViewMatrix no cabe en float sin perder precision
+    Matrix4x4 GetRenderViewMatrix() const;
+
 
     Matrix4x4 GetProjectionMatrix() const;
 
+    // Rayo mundo que pasa por el pixel (x, y) de un viewport width x height (origen arriba-izquierda)
+    Ray ScreenPointToRay(double x, double y, double width, double height) const;
 };
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include "Matrix4x4.hpp"
+#include "Affine3.hpp"
+
+// Comandos de dibujo grabados como datos, sin llamar a la API grafica: cualquier hilo puede grabar
+// su lista y el hilo del contexto las reproduce en orden (utils/CommandReplay.hpp para GL).
+// Stream compacto de registros POD: cabecera + struct del comando + datos extra, todo a 4 bytes
+enum class CommandType : uint8_t {
+    SetProgram,           // CmdSetProgram
+    SetMatrix,            // CmdSetMatrix
+    SetColor,             // CmdSetColor
+    SetModel,             // CmdSetModel: global constante para draws sin instancias
+    BindVertexArray,      // CmdBindVertexArray
+    BindTexture,          // CmdBindTexture: textura del material en la unidad 0
+    BindUniformBuffer,    // CmdBindUniformBuffer: UBO en un binding (p.ej. la paleta de skinning)
+    UploadInstances,      // CmdUploadInstances + count * Affine3f
+    DrawIndexed,          // CmdDrawIndexed
+    DrawIndexedInstanced, // CmdDrawIndexedInstanced
+    IndirectDraw,         // CmdIndirectDraw + count * Affine3f
+    IndirectFlush         // sin datos: envia los IndirectDraw acumulados
+};
+
+enum class UniformSlot : uint32_t { View, Projection, Model };
+
+struct CmdSetProgram { uint32_t program; };
+struct CmdSetMatrix { UniformSlot slot; float m[16]; }; // row-major
+struct CmdSetColor { float rgb[3]; };
+struct CmdSetModel { Affine3f model; };
+struct CmdBindVertexArray { uint32_t vao; };
+struct CmdBindTexture { uint32_t texture; };
+struct CmdBindUniformBuffer { uint32_t binding; uint32_t buffer; };
+struct CmdUploadInstances { uint32_t buffer; uint32_t count; };
+struct CmdDrawIndexed { uint32_t indexCount; };
+struct CmdDrawIndexedInstanced { uint32_t indexCount; uint32_t instanceCount; };
+struct CmdIndirectDraw { uint32_t mesh; uint32_t count; }; // mesh: indice en el MeshPool
+
+struct CommandBuffer
+{
+    struct Header
+    {
+        CommandType type;
+        uint8_t pad[3];
+        uint32_t size; // bytes del registro, cabecera incluida
+    };
+
+    // Vista de un comando al recorrer el buffer
+    struct Command
+    {
+        CommandType type;
+        const uint8_t* data;
+        std::size_t dataBytes;
+
+        template <typename T> T As() const
+        {
+            T cmd;
+            std::memcpy(&cmd, data, sizeof(T));
+            return cmd;
+        }
+        // Datos que van detras del struct del comando (p.ej. las instancias)
+        template <typename T> const uint8_t* Extra() const { return data + sizeof(T); }
+    };
+
+    void Clear() { bytes.clear(); }
+    bool Empty() const { return bytes.empty(); }
+    std::size_t SizeBytes() const { return bytes.size(); }
+
+    void SetProgram(uint32_t program) { Push(CommandType::SetProgram, CmdSetProgram{ program }); }
+    void SetMatrix(UniformSlot slot, const Matrix4x4& m);
+    void SetColor(const Vec3& color);
+    void SetModel(const Affine3f& model) { Push(CommandType::SetModel, CmdSetModel{ model }); }
+    void BindVertexArray(uint32_t vao) { Push(CommandType::BindVertexArray, CmdBindVertexArray{ vao }); }
+    void BindTexture(uint32_t texture) { Push(CommandType::BindTexture, CmdBindTexture{ texture }); }
+    void BindUniformBuffer(uint32_t binding, uint32_t buffer)
+    {
+        Push(CommandType::BindUniformBuffer, CmdBindUniformBuffer{ binding, buffer });
+    }
+    void DrawIndexed(uint32_t indexCount) { Push(CommandType::DrawIndexed, CmdDrawIndexed{ indexCount }); }
+    void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount)
+    {
+        Push(CommandType::DrawIndexedInstanced, CmdDrawIndexedInstanced{ indexCount, instanceCount });
+    }
+    void IndirectFlush() { PushRecord(CommandType::IndirectFlush, nullptr, 0, 0); }
+
+    // Reservan sitio para count instancias y devuelven donde escribirlas (valido hasta el siguiente comando)
+    Affine3f* UploadInstances(uint32_t buffer, uint32_t count);
+    Affine3f* IndirectDraw(uint32_t mesh, uint32_t count);
+
+    template <typename F> void ForEach(F&& visit) const
+    {
+        std::size_t offset = 0;
+        while (offset < bytes.size())
+        {
+            Header h;
+            std::memcpy(&h, bytes.data() + offset, sizeof(Header));
+            visit(Command{ h.type, bytes.data() + offset + sizeof(Header), h.size - sizeof(Header) });
+            offset += h.size;
+        }
+    }
+
+private:
+    template <typename T> void Push(CommandType type, const T& cmd)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % 4 == 0);
+        PushRecord(type, &cmd, sizeof(T), 0);
+    }
+
+    // Devuelve el puntero a los extraBytes sin inicializar que siguen al comando
+    uint8_t* PushRecord(CommandType type, const void* cmd, std::size_t cmdBytes, std::size_t extraBytes);
+
+    std::vector<uint8_t> bytes;
+};
\ No newline at end of file
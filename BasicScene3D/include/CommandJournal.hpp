@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+#include <cstddef>
+#include "GameObject.hpp"
+
+enum class TransformField : uint8_t { Position, Rotation, Scale };
+
+// Historial undo/redo de ediciones de transform.
+// Guarda deltas compactos (objeto, campo, valor viejo/nuevo) en un ring buffer
+// preasignado: grabar no reserva memoria y la memoria total esta acotada.
+struct CommandJournal
+{
+    struct Edit
+    {
+        GameObject* object = nullptr;
+        Vec3 oldValue;
+        Vec3 newValue;
+        TransformField field = TransformField::Position;
+    };
+
+    explicit CommandJournal(std::size_t editCapacity = 1 << 16, std::size_t groupCapacity = 1024);
+
+    // Empieza un tick de edicion. Si el grupo anterior sigue abierto y es del mismo
+    // campo, los Record de este tick se fusionan con el (arrastre de un DragFloat3)
+    void BeginTick(TransformField field);
+    void Record(GameObject* object, const Vec3& oldValue, const Vec3& newValue);
+
+    // Cierra el grupo actual (fin del arrastre); el siguiente tick abre uno nuevo
+    void CloseGroup() { groupOpen = false; overflowed = false; }
+
+    bool CanUndo() const { return groupCursor > groupTail; }
+    bool CanRedo() const { return groupCursor < groupHead; }
+
+    // O(ediciones del grupo); llaman a MarkWorldDirty de cada objeto tocado
+    bool Undo();
+    bool Redo();
+
+    void Clear();
+
+    // Objetos que se van a borrar (p.ej. una celda descargada): sus ediciones se quedan sin objeto y
+    // Undo/Redo las saltan. O(ediciones guardadas)
+    void Forget(const std::unordered_set<const GameObject*>& objects);
+
+    static Vec3 Read(const GameObject* object, TransformField field);
+    static void Write(GameObject* object, TransformField field, const Vec3& value);
+
+private:
+    struct Group
+    {
+        uint64_t first = 0;  // indice absoluto de la primera edicion
+        uint32_t count = 0;
+        TransformField field = TransformField::Position;
+    };
+
+    Edit& EditAt(uint64_t i) { return edits[i % edits.size()]; }
+    Group& GroupAt(uint64_t i) { return groups[i % groups.size()]; }
+    void EvictOldestGroup();
+
+    std::vector<Edit> edits;
+    std::vector<Group> groups;
+
+    // Indices absolutos (crecen siempre); posicion fisica = indice % capacidad
+    uint64_t editTail = 0, editHead = 0;
+    uint64_t groupTail = 0, groupCursor = 0, groupHead = 0;
+
+    bool groupOpen = false;
+    bool overflowed = false;  // el grupo abierto no cabe entero: se descarta
+    uint32_t tickIndex = 0;   // posicion dentro del grupo en el tick actual
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include "Quat.hpp"
+#include "Affine3.hpp"
+#include "Transform.hpp"
+
+// Transformacion rigida (rotacion + traslacion) en 8 escalares: q = real + eps * dual,
+// con dual = 0.5 * (0, t) * real. Solo para cadenas sin escala
+struct DualQuat
+{
+    Quat real;
+    Quat dual{ 0, 0, 0, 0 };
+
+    static constexpr DualQuat Identity() { return {}; }
+
+    static constexpr DualQuat FromRotationTranslation(const Quat& r, const Vec3& t)
+    {
+        const Quat d = Quat{ 0, t.x, t.y, t.z } * r;
+        return { r, { 0.5 * d.s, 0.5 * d.x, 0.5 * d.y, 0.5 * d.z } };
+    }
+
+    // Ignoran la escala (asumen transform rigida)
+    static DualQuat FromTransform(const Transform& t);
+    static DualQuat FromAffine3(const Affine3& M);
+    // Comprobada: lanza excepcion si la parte 3x3 no es una rotacion
+    static DualQuat FromMatrix4x4(const Matrix4x4& M);
+
+    Transform ToTransform() const;
+    Affine3 ToAffine3() const;
+    Matrix4x4 ToMatrix4x4() const;
+
+    constexpr Vec3 GetTranslation() const
+    {
+        // t = 2 * dual * conj(real)
+        const Quat t = dual * real.Conjugate();
+        return { 2.0 * t.x, 2.0 * t.y, 2.0 * t.z };
+    }
+    constexpr const Quat& GetRotation() const { return real; }
+
+    // Mismo orden que Matrix4x4: (A * B) aplica primero B. 3 productos de Quat (48 mul)
+    constexpr DualQuat Multiply(const DualQuat& b) const
+    {
+        const Quat d0 = real * b.dual;
+        const Quat d1 = dual * b.real;
+        return { real * b.real, { d0.s + d1.s, d0.x + d1.x, d0.y + d1.y, d0.z + d1.z } };
+    }
+    constexpr DualQuat operator*(const DualQuat& b) const { return Multiply(b); }
+
+    // Para unitarios la inversa es el conjugado de ambas partes
+    constexpr DualQuat Inverse() const { return { real.Conjugate(), dual.Conjugate() }; }
+
+    constexpr Vec3 TransformPoint(const Vec3& p) const
+    {
+        const Vec3 r = real.Rotate(p);
+        const Vec3 t = GetTranslation();
+        return { r.x + t.x, r.y + t.y, r.z + t.z };
+    }
+    constexpr Vec3 TransformVector(const Vec3& v) const { return real.Rotate(v); }
+
+    // Divide por |real| y quita la componente de dual paralela a real (deriva numerica)
+    DualQuat Normalized() const;
+};
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// Reloj de simulacion a paso fijo: el tiempo real (contador de alta resolucion) se acumula y se
+// consume en pasos de Step() segundos. El render interpola entre los dos ultimos estados con Alpha().
+// Si un frame lento pide mas de maxSteps pasos, el resto se descarta (la simulacion va mas lenta
+// en vez de entrar en espiral)
+struct FixedTimestep
+{
+    FixedTimestep(uint64_t counterFrequency, double hz = 60.0, int maxSteps = 5);
+
+    // Reinicia la referencia sin simular el tiempo pasado (al arrancar o tras dormir)
+    void Reset(uint64_t counter);
+
+    // Pasos de simulacion que tocan hasta 'counter'
+    int Advance(uint64_t counter);
+
+    // Fraccion del siguiente paso ya transcurrida, en [0, 1)
+    double Alpha() const { return accumulator / step; }
+
+    double Step() const { return step; }
+    void SetRate(double hz);
+
+    int maxSteps;
+
+private:
+    double frequency;
+    double step;
+    double accumulator = 0.0;
+    uint64_t last = 0;
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+// Pipeline de dos etapas con doble buffer: un hilo de simulacion produce el frame N+1 en el buffer
+// de atras mientras el hilo de GL envia el frame N desde el de delante.
+// Entre Wait() y el siguiente Kick() el hilo de simulacion esta parado y la escena se puede modificar
+struct FramePipeline
+{
+    // produce(buffer) se ejecuta en el hilo de simulacion con el indice del buffer de atras
+    explicit FramePipeline(std::function<void(int)> produce);
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    int Front() const { return front.load(std::memory_order_acquire); }
+    int Back() const { return 1 - Front(); }
+
+    // Empieza a producir en Back(); no puede haber otro Kick sin su Wait
+    void Kick();
+
+    // Espera a que acabe el Kick pendiente (si lo hay) y pasa su buffer a ser el de delante
+    void WaitAndSwap();
+
+private:
+    void SimLoop();
+
+    std::function<void(int)> produce;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable kicked;
+    std::condition_variable done;
+    std::atomic<int> front{ 0 };
+    uint64_t requested = 0; // Kicks pedidos
+    uint64_t completed = 0; // Kicks terminados
+    uint64_t swapped = 0;   // Kicks cuyo buffer ya esta delante
+    bool stopping = false;
+};
\ No newline at end of file
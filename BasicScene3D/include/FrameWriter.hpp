@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+// PPM: P6 RGB (sin alfa). Raw: RGBA8 sin cabecera, ancho y alto los da quien lo lee
+enum class FrameFormat { PPM, Raw };
+
+// Escribe frames a disco en un hilo propio para que el hilo de GL no espere al disco.
+// Los frames llegan como los da glReadPixels (RGBA8, fila 0 abajo) y se guardan con la fila 0 arriba
+// en directory/frame_00000.ppm, frame_00001.ppm, ... (directory se crea si no existe)
+struct FrameWriter
+{
+    // maxQueued: frames en cola antes de que Submit bloquee (limita la memoria si el disco no da abasto)
+    FrameWriter(std::string directory, FrameFormat format, std::size_t maxQueued = 4);
+    ~FrameWriter();
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    void Submit(std::vector<uint8_t>&& rgba, int width, int height);
+
+    // Espera a que se escriba todo lo encolado y para el hilo
+    void Close();
+
+    std::size_t Written() const;
+    // Primer error de escritura (vacio si no hay); a partir de ahi se descartan los frames
+    std::string Error() const;
+
+private:
+    struct Frame
+    {
+        std::vector<uint8_t> rgba;
+        int width = 0, height = 0;
+        std::size_t index = 0;
+    };
+
+    void WriterLoop();
+    bool WriteFrame(const Frame& frame, std::vector<uint8_t>& scratch);
+
+    std::string directory;
+    FrameFormat format;
+    std::size_t maxQueued;
+
+    std::thread thread;
+    mutable std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable drained;
+    std::deque<Frame> frames;
+    std::size_t submitted = 0;
+    std::size_t written = 0;
+    std::string error;
+    bool closing = false;
+};
\ No newline at end of file
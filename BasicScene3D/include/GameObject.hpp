@@ -2,7 +2,10 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "Transform.hpp"
+#include "DualQuat.hpp"
+#include "Light.hpp"
 
 struct GameObject
 {
@@ -13,11 +16,37 @@ struct GameObject
     std::string name;
     Transform transform;
 
+    // Se rasteriza en el buffer de OcclusionCuller (paredes, suelos grandes...)
+    bool occluder = false;
+
+    // Luz puntual o foco (LightClusters); un objeto con luz no se dibuja como cubo
+    Light light;
+
+    // Malla de AssetManager (AssetHandle::id); 0 o aun sin cargar: cubo unidad
+    uint32_t mesh = 0;
+    // Textura de AssetManager; 0 o aun sin cargar: blanca
+    uint32_t texture = 0;
+
     GameObject* parent = nullptr;
     std::vector<GameObject*> children;
 
     void AddChild(GameObject* child);
 
-    Matrix4x4 GetGlobalMatrix() const;
-    
-};
\ No newline at end of file
+    // Cacheada; la referencia vale hasta el siguiente MarkWorldDirty
+    const Affine3& GetGlobalMatrix() const;
+
+    // Propagacion rigida: global del padre por la local en dual quat (ignora la escala). Cacheada
+    // como GetGlobalMatrix, con su propio flag porque cada una se limpia por separado
+    const DualQuat& GetGlobalDualQuat() const;
+
+    // Llamar despues de modificar transform: invalida las globales cacheadas de todo el subarbol.
+    // Invariante (para cada flag): si un nodo esta sucio, todos sus descendientes tambien
+    void MarkWorldDirty();
+    bool IsWorldDirty() const { return worldDirty; }
+
+private:
+    mutable Affine3 worldMatrix;
+    mutable bool worldDirty = true;
+    mutable DualQuat worldDQ;
+    mutable bool worldDQDirty = true;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_set>
+#include "GameObject.hpp"
+#include "Selection.hpp"
+
+// Panel "Hierarchy" virtualizado: aplana solo las filas expandidas en una lista
+// cacheada y dibuja con ImGuiListClipper solo las visibles
+struct HierarchyView
+{
+    struct Row
+    {
+        GameObject* node = nullptr;
+        int depth = 0;
+    };
+
+    // Llamar cuando se anaden/quitan objetos o cambia un nombre
+    void MarkDirty() { rowsDirty = true; searchDirty = true; }
+
+    // Dibuja dentro de la ventana actual; devuelve true si ha cambiado la seleccion.
+    // Click, Ctrl+click, Shift+click y seleccion por caja (arrastrando desde un hueco)
+    bool Draw(const std::vector<GameObject*>& roots, Selection& selection);
+
+    bool IsExpanded(GameObject* node) const { return expanded.count(node) != 0; }
+    void SetExpanded(GameObject* node, bool open);
+
+    // Expande los ancestros para que el nodo tenga fila (p.ej. al seleccionar desde el viewport)
+    void Reveal(GameObject* node);
+
+    const std::vector<Row>& Rows() const { return rows; }
+
+private:
+    void RebuildRows(const std::vector<GameObject*>& roots);
+    void UpdateSearch(const std::vector<GameObject*>& roots);
+
+    std::vector<Row> rows;
+    std::unordered_set<GameObject*> expanded;
+    bool rowsDirty = true;
+
+    char searchBuffer[128] = { 0 };
+    std::string lastQuery;
+    std::vector<GameObject*> matches;
+    bool searchDirty = true;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+// Pool fijo de hilos para trabajo de datos paralelo dentro de un frame.
+// ParallelFor bloquea hasta acabar y el hilo que llama tambien coge trozos
+struct JobSystem
+{
+    // workers = 0: hardware_concurrency - 1 (el hilo que llama es el que falta)
+    explicit JobSystem(unsigned workers = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned WorkerCount() const { return static_cast<unsigned>(threads.size()); }
+
+    // fn(begin, end) sobre [0, count) en trozos de grain elementos
+    void ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn);
+
+private:
+    void WorkerLoop();
+    void RunChunks();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::mutex submitMutex; // un ParallelFor a la vez
+
+    // Trabajo actual (valido mientras pending > 0)
+    const std::function<void(std::size_t, std::size_t)>* job = nullptr;
+    std::size_t jobCount = 0;
+    std::size_t jobGrain = 1;
+    std::atomic<std::size_t> nextChunk{ 0 };
+    std::atomic<std::size_t> pending{ 0 };
+    uint64_t generation = 0;
+    unsigned active = 0; // workers dentro de RunChunks: el trabajo no se reemplaza hasta que salen
+    bool stopping = false;
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Matrix3x3.hpp"
+
+enum class LightType { None, Point, Spot };
+
+// Luz dinamica de un GameObject: la posicion es la de su global y un foco apunta por su -Z local
+// (como la camara). None: el objeto no emite
+struct Light
+{
+    LightType type = LightType::None;
+    Vec3 color{ 1.0, 1.0, 1.0 };
+    double intensity = 4.0;
+    double range = 5.0;       // la atenuacion llega a 0 en range
+    double innerAngle = 0.35; // foco: semiangulo (radianes) sin atenuacion
+    double outerAngle = 0.55; // foco: semiangulo donde se apaga
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Light.hpp"
+#include "Camera.hpp"
+#include "JobSystem.hpp"
+
+// Forward por clusters: el frustum de la camara se parte en DimX x DimY tiles de pantalla y DimZ
+// slices de profundidad exponenciales. En CPU cada luz se asigna a los clusters que toca su esfera
+// (un slice por job, 4 luces por comparacion SIMD) y el fragment shader solo recorre la lista de su
+// cluster: el coste por pixel depende de las luces cercanas, no de las de la escena
+struct LightClusters
+{
+    static constexpr uint32_t DimX = 16;
+    static constexpr uint32_t DimY = 9;
+    static constexpr uint32_t DimZ = 24;
+    static constexpr uint32_t ClusterCount = DimX * DimY * DimZ;
+
+    // Luz en mundo tal como la lee fs.glsl: 3 texels RGBA32F
+    struct GpuLight
+    {
+        float position[3]; float range;
+        float color[3]; float cosInner;      // color * intensidad
+        float direction[3]; float cosOuter;  // puntual: cono abierto (cosOuter < -1)
+    };
+    static_assert(sizeof(GpuLight) == 48);
+
+    // Limites de los buffers de textura (GL_MAX_TEXTURE_BUFFER_SIZE); lo que no cabe se descarta
+    std::size_t maxLights = 65536 / 3;
+    std::size_t maxIndices = 65536;
+
+    // Empieza un frame. Las posiciones se guardan relativas a origin (restadas en double): con la
+    // camara como origen no pierden precision lejos del origen del mundo
+    void Begin(const Vec3& origin = {});
+
+    void AddLight(const Affine3& world, const Light& light);
+
+    // Asigna las luces anadidas a los clusters del frustum de camera
+    void Build(const Camera& camera, JobSystem& jobs);
+
+    const std::vector<GpuLight>& Lights() const { return lights; }
+    // (offset, count) en Indices() por cluster; x varia mas rapido, despues y, despues el slice
+    const std::vector<uint32_t>& Grid() const { return grid; }
+    const std::vector<uint32_t>& Indices() const { return indices; }
+
+    // slice = log(profundidad) * DepthScale() + DepthBias()
+    float DepthScale() const { return depthScale; }
+    float DepthBias() const { return depthBias; }
+
+private:
+    // Esferas en espacio vista en SoA, con relleno hasta multiplo de 4 (radio^2 negativo: nunca tocan)
+    struct SliceScratch
+    {
+        std::vector<float> x, y, z, radius2;
+        std::vector<uint32_t> light;
+        std::vector<uint32_t> indices;
+    };
+
+    void AssignSlice(uint32_t slice, float zNear, float zFar, float tanX, float tanY);
+
+    std::vector<GpuLight> lights;
+    std::vector<float> boundsX, boundsY, boundsZ, boundsRadius; // esferas en mundo (- origin)
+    std::vector<float> viewX, viewY, viewZ;                     // y en vista, por Build
+    std::vector<SliceScratch> slices = std::vector<SliceScratch>(DimZ);
+    std::vector<uint32_t> grid = std::vector<uint32_t>(ClusterCount * 2, 0);
+    std::vector<uint32_t> indices;
+    float depthScale = 0.0f, depthBias = 0.0f;
+    Vec3 origin;
+};
\ No newline at end of file
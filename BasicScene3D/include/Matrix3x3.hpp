@@ -7,8 +7,14 @@ struct Vec3
 {
     double x = 0, y = 0, z = 0;
 
-    static double Dot(const Vec3& a, const Vec3& b);
-    static Vec3 Cross(const Vec3& a, const Vec3& b);
+    static constexpr double Dot(const Vec3& a, const Vec3& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+    static constexpr Vec3 Cross(const Vec3& a, const Vec3& b)
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
     double Norm() const;
     Vec3 Normalize() const;
 };
@@ -18,30 +24,69 @@ struct Matrix3x3
     // Row-major
     double m[9] = { 0 };
 
-    static Matrix3x3 Identity();
-    double& At(std::size_t i, std::size_t j) { return m[i * 3 + j]; }
-    double  At(std::size_t i, std::size_t j) const { return m[i * 3 + j]; }
+    static constexpr Matrix3x3 Identity()
+    {
+        Matrix3x3 I;
+        I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1;
+        return I;
+    }
+    constexpr double& At(std::size_t i, std::size_t j) { return m[i * 3 + j]; }
+    constexpr double  At(std::size_t i, std::size_t j) const { return m[i * 3 + j]; }
 
-    Vec3 Multiply(const Vec3& x) const;
-    Matrix3x3 Multiply(const Matrix3x3& B) const;
+    constexpr Vec3 Multiply(const Vec3& x) const
+    {
+        // y = A * x
+        return {
+            At(0, 0) * x.x + At(0, 1) * x.y + At(0, 2) * x.z,
+            At(1, 0) * x.x + At(1, 1) * x.y + At(1, 2) * x.z,
+            At(2, 0) * x.x + At(2, 1) * x.y + At(2, 2) * x.z
+        };
+    }
+    constexpr Matrix3x3 Multiply(const Matrix3x3& B) const
+    {
+        Matrix3x3 C{};
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                C.At(i, j) = At(i, 0) * B.At(0, j) + At(i, 1) * B.At(1, j) + At(i, 2) * B.At(2, j);
+        return C;
+    }
 
-    Vec3 operator*(const Vec3& x) const
+    constexpr Vec3 operator*(const Vec3& x) const
     {
         return Multiply(x);
     }
-    Matrix3x3 operator*(const Matrix3x3& B) const
+    constexpr Matrix3x3 operator*(const Matrix3x3& B) const
     {
         return Multiply(B);
     }
 
-    double Det() const;
-    Matrix3x3 Transposed() const;
-    double Trace() const;
+    constexpr double Det() const
+    {
+        const double a = At(0, 0), b = At(0, 1), c = At(0, 2);
+        const double d = At(1, 0), e = At(1, 1), f = At(1, 2);
+        const double g = At(2, 0), h = At(2, 1), i = At(2, 2);
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    }
+    constexpr Matrix3x3 Transposed() const
+    {
+        Matrix3x3 R{};
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                R.At(i, j) = At(j, i);
+        return R;
+    }
+    constexpr double Trace() const
+    {
+        return At(0, 0) + At(1, 1) + At(2, 2);
+    }
 
     bool IsRotation() const;
     static Matrix3x3 RotationAxisAngle(const Vec3& u, double phi);
     void ToAxisAngle(Vec3& axis, double& angle) const;
-    Vec3 Rotate(const Vec3& v) const;
+    constexpr Vec3 Rotate(const Vec3& v) const
+    {
+        return Multiply(v);
+    }
 
     static Matrix3x3 FromEulerZYX(double yaw, double pitch, double roll);
     void ToEulerZYX(double& yaw, double& pitch, double& roll) const;
@@ -7,53 +7,140 @@ struct Vec4
 {
     double x = 0, y = 0, z = 0, w = 0;
 
-    Vec4() = default;
-    Vec4(double _x, double _y, double _z, double _w) : x(_x), y(_y), z(_z), w(_w) {}
-    Vec4(const Vec3& v, double _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
+    constexpr Vec4() = default;
+    constexpr Vec4(double _x, double _y, double _z, double _w) : x(_x), y(_y), z(_z), w(_w) {}
+    constexpr Vec4(const Vec3& v, double _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
 };
 
+// Las operaciones basicas son constexpr e inline en la cabecera: se pueden
+// evaluar en tiempo de compilacion y se inlinean en cualquier TU sin LTO
 struct Matrix4x4
 {
     // Row-major: m[row * 4 + col]
     double m[16] = { 0 };
 
     static Matrix4x4 Perspective(double left, double right, double bottom, double top, double nearPlane, double farPlane);
-    static Matrix4x4 Identity();
-    double& At(std::size_t i, std::size_t j) { return m[i * 4 + j]; }
-    double  At(std::size_t i, std::size_t j) const { return m[i * 4 + j]; }
+    static constexpr Matrix4x4 Identity()
+    {
+        Matrix4x4 I;
+        I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1; I.At(3, 3) = 1;
+        return I;
+    }
+    constexpr double& At(std::size_t i, std::size_t j) { return m[i * 4 + j]; }
+    constexpr double  At(std::size_t i, std::size_t j) const { return m[i * 4 + j]; }
 
-    Matrix4x4 Multiply(const Matrix4x4& B) const;
-    Vec4 Multiply(const Vec4& v) const;
+    constexpr Matrix4x4 Multiply(const Matrix4x4& B) const
+    {
+        Matrix4x4 C{};
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                C.At(i, j) = At(i, 0) * B.At(0, j) + At(i, 1) * B.At(1, j) + At(i, 2) * B.At(2, j) + At(i, 3) * B.At(3, j);
+        return C;
+    }
+    constexpr Vec4 Multiply(const Vec4& v) const
+    {
+        return {
+            At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z + At(0, 3) * v.w,
+            At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z + At(1, 3) * v.w,
+            At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z + At(2, 3) * v.w,
+            At(3, 0) * v.x + At(3, 1) * v.y + At(3, 2) * v.z + At(3, 3) * v.w
+        };
+    }
 
-    bool IsAffine() const;
+    constexpr bool IsAffine() const
+    {
+        return At(3, 0) == 0 && At(3, 1) == 0 && At(3, 2) == 0 && At(3, 3) == 1;
+    }
 	
     // Transformacions de punts i vectors
-	Vec3 TransformPoint(const Vec3& p) const;
-	Vec3 TransformVector(const Vec3& v) const;
+	constexpr Vec3 TransformPoint(const Vec3& p) const
+    {
+        Vec4 r = Multiply(Vec4(p, 1.0));
+        return { r.x, r.y, r.z };
+    }
+	constexpr Vec3 TransformVector(const Vec3& v) const
+    {
+        Vec4 r = Multiply(Vec4(v, 0.0));
+        return { r.x, r.y, r.z };
+    }
 
     // Statics
-    static Matrix4x4 Translate(const Vec3& t);
-    static Matrix4x4 Scale(const Vec3& s);
-    static Matrix4x4 Rotate(const Matrix3x3& R);
+    static constexpr Matrix4x4 Translate(const Vec3& t)
+    {
+        Matrix4x4 M = Identity();
+        M.At(0, 3) = t.x;
+        M.At(1, 3) = t.y;
+        M.At(2, 3) = t.z;
+        return M;
+    }
+    static constexpr Matrix4x4 Scale(const Vec3& s)
+    {
+        Matrix4x4 M;
+        M.At(0, 0) = s.x;
+        M.At(1, 1) = s.y;
+        M.At(2, 2) = s.z;
+        M.At(3, 3) = 1;
+        return M;
+    }
+    static constexpr Matrix4x4 Rotate(const Matrix3x3& R)
+    {
+        return FromTRS({ 0, 0, 0 }, R, { 1, 1, 1 });
+    }
     static Matrix4x4 Rotate(const Quat& q);
-    static Matrix4x4 FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s);
+    static constexpr Matrix4x4 FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s)
+    {
+        // Columna j de la 3x3 = columna j de R escalada por s[j]
+        Matrix4x4 M = Identity();
+        M.At(0, 0) = R.At(0, 0) * s.x; M.At(0, 1) = R.At(0, 1) * s.y; M.At(0, 2) = R.At(0, 2) * s.z;
+        M.At(1, 0) = R.At(1, 0) * s.x; M.At(1, 1) = R.At(1, 1) * s.y; M.At(1, 2) = R.At(1, 2) * s.z;
+        M.At(2, 0) = R.At(2, 0) * s.x; M.At(2, 1) = R.At(2, 1) * s.y; M.At(2, 2) = R.At(2, 2) * s.z;
+        M.At(0, 3) = t.x;
+        M.At(1, 3) = t.y;
+        M.At(2, 3) = t.z;
+        return M;
+    }
     static Matrix4x4 FromTRS(const Vec3& t, const Quat& q, const Vec3& s);
 
 	// Inverses
     Matrix4x4 InverseTR() const;
 	Matrix4x4 InverseTRS() const;
+    Matrix4x4 Inverse() const;
 
     // Getters de components
-    Vec3 GetTranslation() const;
+    constexpr Vec3 GetTranslation() const
+    {
+        return { At(0, 3), At(1, 3), At(2, 3) };
+    }
 	Matrix3x3 GetRotation() const;
+    // Si ya se tiene la escala (p.ej. de GetScale o Decompose) evita recalcularla
+    Matrix3x3 GetRotation(const Vec3& scale) const;
+    // Descomposicion TRS en una sola pasada (la escala se calcula una vez)
+    void Decompose(Vec3& t, Matrix3x3& R, Vec3& s) const;
 	Quat GetRotationQuat() const;
 	Vec3 GetScale() const;
-    Matrix3x3 GetRotationScale() const;
+    constexpr Matrix3x3 GetRotationScale() const
+    {
+        Matrix3x3 M;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                M.At(i, j) = At(i, j);
+        return M;
+    }
 
 	// Setters de components
-	void SetTranslation(const Vec3& t);
+	constexpr void SetTranslation(const Vec3& t)
+    {
+        At(0, 3) = t.x;
+        At(1, 3) = t.y;
+        At(2, 3) = t.z;
+    }
 	void SetRotation(const Matrix3x3& R);
 	void SetRotation(const Quat& q);
 	void SetScale(const Vec3& s);
-	void SetRotationScale(const Matrix3x3& RS);
-};
\ No newline at end of file
+	constexpr void SetRotationScale(const Matrix3x3& RS)
+    {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                At(i, j) = RS.At(i, j);
+    }
+};
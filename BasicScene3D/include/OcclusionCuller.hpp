@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Ray.hpp"
+#include "JobSystem.hpp"
+
+// Culling por oclusion en CPU: los oclusores marcados se rasterizan a baja resolucion en un
+// buffer de profundidad (SIMD, una banda de filas por job) y despues se prueban las cajas de los
+// ocluidos contra el. Profundidad = z de ventana [0, 1], 1 = lejos
+struct OcclusionCuller
+{
+    static constexpr int Width = 256;
+    static constexpr int Height = 144;
+    static constexpr int BandHeight = 16;
+
+    // Empieza un frame: limpia los oclusores y guarda la view-projection
+    void Begin(const Matrix4x4& viewProj);
+
+    // Malla local (posiciones xyz, triangulos indexados) transformada por world
+    void AddOccluder(const Affine3& world, const float* positions, const unsigned int* indices, int indexCount);
+
+    // Transforma los triangulos y rellena el buffer en paralelo
+    void Rasterize(JobSystem& jobs);
+
+    // true si algun pixel de la caja puede estar delante del buffer (conservativo).
+    // Las cajas fuera de pantalla o detras de la camara devuelven false; las que cruzan su plano, true
+    bool IsVisible(const AABB& box) const;
+
+    const std::vector<float>& Depth() const { return depth; }
+    std::size_t TriangleCount() const { return triangles.size(); }
+
+private:
+    // Vertices ya en pixeles (x, y) y profundidad de ventana
+    struct ScreenTriangle
+    {
+        float x[3], y[3], z[3];
+        int minY, maxY;
+    };
+
+    void RasterizeBand(int y0, int y1);
+
+    Matrix4x4 viewProj;
+    std::vector<Vec3> vertices;          // posiciones mundo de todos los oclusores
+    std::vector<unsigned int> indices;   // en vertices
+    std::vector<ScreenTriangle> triangles;
+    std::vector<float> depth = std::vector<float>(Width * Height, 1.0f);
+};
\ No newline at end of file
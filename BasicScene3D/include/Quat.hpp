@@ -6,23 +6,55 @@ struct Quat
     double s = 1, x = 0, y = 0, z = 0;
 
     Quat Normalized() const;
-    Quat Multiply(const Quat& b) const;
-    Quat operator*(const Quat& b) const
+    constexpr Quat Conjugate() const
+    {
+        return { s, -x, -y, -z };
+    }
+    constexpr Quat Multiply(const Quat& b) const
+    {
+        const Quat& a = *this;
+        Quat q;
+        q.s = a.s * b.s - a.x * b.x - a.y * b.y - a.z * b.z;
+        q.x = a.s * b.x + a.x * b.s + a.y * b.z - a.z * b.y;
+        q.y = a.s * b.y - a.x * b.z + a.y * b.s + a.z * b.x;
+        q.z = a.s * b.z + a.x * b.y - a.y * b.x + a.z * b.s;
+        return q;
+    }
+    constexpr Quat operator*(const Quat& b) const
     {
         return Multiply(b);
 	}
 
-    Vec3 Rotate(const Vec3& v) const;
+    constexpr Vec3 Rotate(const Vec3& v) const
+    {
+        // v' = v + 2s(q x v) + 2 q x (q x v)
+        const Vec3 qv{ x, y, z };
+        Vec3 t = Vec3::Cross(qv, v);
+        t.x *= 2.0; t.y *= 2.0; t.z *= 2.0;
+        const Vec3 cqt = Vec3::Cross(qv, t);
+        return { v.x + s * t.x + cqt.x, v.y + s * t.y + cqt.y, v.z + s * t.z + cqt.z };
+    }
 
+    // Versiones comprobadas: validan la entrada (lanzan excepcion) y normalizan
     static Quat FromMatrix3x3(const Matrix3x3& R);
     Matrix3x3 ToMatrix3x3() const;
 
+    // Versiones sin comprobar para caminos calientes: asumen rotacion valida / cuaternion unitario.
+    // En Debug lo verifican con assert; en Release no hay validacion ni renormalizacion
+    static Quat FromMatrix3x3Unchecked(const Matrix3x3& R);
+    Matrix3x3 ToMatrix3x3Unchecked() const;
+    bool IsUnit(double tol = 1e-6) const;
+
     static Quat FromAxisAngle(const Vec3& u, double phi);
     void ToAxisAngle(Vec3& axis, double& angle) const;
 
+    // Forma cerrada, sin pasar por Matrix3x3 (q = qz(yaw) * qy(pitch) * qx(roll))
     static Quat FromEulerZYX(double yaw, double pitch, double roll);
     void ToEulerZYX(double& yaw, double& pitch, double& roll) const;
 
     static Quat RotateFromTo(const Vec3& u, const Vec3& v);
     static Quat RotateToTarget(const Quat& initialRot, const Quat& finalRot);
+
+    // Interpolacion esferica por el camino corto (a y b unitarios); casi paralelos -> nlerp
+    static Quat Slerp(const Quat& a, const Quat& b, double t);
 };
\ No newline at end of file
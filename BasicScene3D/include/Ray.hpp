@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Affine3.hpp"
+
+struct AABB
+{
+    Vec3 min{ 1e300, 1e300, 1e300 };
+    Vec3 max{ -1e300, -1e300, -1e300 };
+
+    void Expand(const Vec3& p);
+    void Expand(const AABB& b);
+    Vec3 Center() const;
+    double SurfaceArea() const;
+    bool IsEmpty() const { return min.x > max.x; }
+
+    // AABB mundo de la caja local [-h, h] transformada por M
+    static AABB FromOBB(const Affine3& M, const Vec3& halfExtents);
+};
+
+struct Ray
+{
+    Vec3 origin;
+    Vec3 direction;
+
+    Vec3 At(double t) const;
+
+    // Slab test; invDir precalculado para recorrer arboles sin dividir en cada nodo
+    static bool IntersectAABB(const Vec3& origin, const Vec3& invDir, const AABB& box, double tMax, double& tHit);
+
+    // Caja local [-h, h] con transform invWorld = inversa de la global del objeto
+    static bool IntersectOBB(const Ray& ray, const Affine3& invWorld, const Vec3& halfExtents, double& tHit);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Orden de los bits de la clave (de mas a menos significativo):
+// pass(4) | program(12) | mesh(12) | material(12) | depth(24)
+// Ordenar por clave agrupa los cambios de estado caros y, dentro de un mismo estado, ordena por profundidad
+enum class RenderPass : uint8_t { Opaque = 0, Transparent = 1 };
+
+struct RenderItem
+{
+    uint64_t key = 0;
+    uint32_t index = 0; // indice en la lista de draws del que hace Submit
+};
+
+struct RenderQueue
+{
+    static constexpr int DepthBits = 24;
+    static constexpr uint64_t StateMask = ~((uint64_t(1) << DepthBits) - 1);
+    static constexpr uint64_t BatchMask = StateMask & ~(uint64_t(0xFFF) << 36);
+
+    // Opaque: de delante a atras (early-Z). Transparent: de atras a delante (blending)
+    static uint64_t MakeKey(RenderPass pass, uint32_t program, uint32_t mesh, uint32_t material, uint32_t depth);
+
+    // Profundidad en espacio vista a 24 bits, lineal entre near y far
+    static uint32_t QuantizeDepth(double viewDepth, double nearPlane, double farPlane);
+
+    // Dos claves con el mismo estado se pueden dibujar sin rebinds (p.ej. en el mismo draw instanciado)
+    static bool SameState(uint64_t a, uint64_t b) { return ((a ^ b) & StateMask) == 0; }
+
+    // Igual salvo malla y profundidad: con un pool de mallas se puede juntar en un solo multi-draw
+    static bool SameBatch(uint64_t a, uint64_t b) { return ((a ^ b) & BatchMask) == 0; }
+
+    void Clear() { items.clear(); }
+    void Submit(uint64_t key, uint32_t index) { items.push_back({ key, index }); }
+
+    // Radix sort LSD de 8 bits; se saltan las pasadas en que todas las claves comparten el byte
+    void Sort();
+
+    const std::vector<RenderItem>& Items() const { return items; }
+
+private:
+    std::vector<RenderItem> items;
+    std::vector<RenderItem> scratch;
+};
\ No newline at end of file
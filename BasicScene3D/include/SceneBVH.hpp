@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "Ray.hpp"
+#include "GameObject.hpp"
+
+struct RayHit
+{
+    GameObject* object = nullptr;
+    double t = 1e300;
+};
+
+// BVH sobre las OBBs de los GameObjects (caja de su malla transformada por su global)
+struct SceneBVH
+{
+    struct Node
+    {
+        AABB bounds;
+        uint32_t first = 0;  // hoja: primer primitivo; interno: hijo izquierdo (el derecho es first + 1)
+        uint32_t count = 0;  // 0 = nodo interno
+    };
+
+    struct Primitive
+    {
+        GameObject* object = nullptr;
+        Affine3 invWorld;
+        Vec3 halfExtents;
+        AABB bounds;
+        Vec3 centroid;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Primitive> prims;
+
+    // Reconstruye el arbol: cambios de estructura (nodos nuevos o borrados, mallas que llegan).
+    // halfExtentsOf: caja local de la malla de un nodo (GameObject::mesh)
+    void Build(const std::vector<GameObject*>& roots, const std::function<Vec3(uint32_t)>& halfExtentsOf);
+    // Solo han cambiado transforms: recalcula las cajas con la misma topologia, O(n) sin SAH.
+    // El arbol puede ir empeorando si los objetos se mueven mucho, pero sigue siendo correcto
+    void Refit();
+    bool Raycast(const Ray& ray, RayHit& hit) const;
+    bool Empty() const { return nodes.empty(); }
+
+private:
+    void Gather(GameObject* node, const Affine3& parentWorld, const std::function<Vec3(uint32_t)>& halfExtentsOf);
+    void Subdivide(uint32_t nodeIndex, int depth);
+};
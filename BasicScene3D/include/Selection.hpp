@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include "GameObject.hpp"
+
+struct CommandJournal;
+
+// Seleccion multiple de GameObjects con ediciones de transform en lote
+struct Selection
+{
+    const std::vector<GameObject*>& Items() const { return items; }
+    bool Empty() const { return items.empty(); }
+    std::size_t Size() const { return items.size(); }
+    bool Contains(const GameObject* obj) const { return lookup.count(obj) != 0; }
+
+    // Ultimo objeto seleccionado (el que muestra el Inspector)
+    GameObject* Primary() const { return items.empty() ? nullptr : items.back(); }
+
+    void Clear();
+    void Set(GameObject* obj);
+    void Add(GameObject* obj);
+    void Remove(GameObject* obj);
+    void Toggle(GameObject* obj);
+
+    // Objetos seleccionados sin ningun ancestro seleccionado: mover un padre ya mueve a sus hijos
+    const std::vector<GameObject*>& SubtreeRoots() const;
+
+    // Ediciones en lote: una pasada sobre SubtreeRoots y una invalidacion por subarbol.
+    // Con journal, la misma pasada graba los valores viejo/nuevo para undo
+    void Translate(const Vec3& delta, CommandJournal* journal = nullptr);
+    void RotateEuler(const Vec3& delta, CommandJournal* journal = nullptr);
+    void AddScale(const Vec3& delta, CommandJournal* journal = nullptr);
+
+private:
+    std::vector<GameObject*> items;
+    std::unordered_set<const GameObject*> lookup;
+
+    mutable std::vector<GameObject*> roots;
+    mutable bool rootsDirty = true;
+};
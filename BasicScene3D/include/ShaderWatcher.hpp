@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <filesystem>
+#include <chrono>
+
+// Vigila ficheros en un hilo propio comparando la fecha de modificacion cada intervalo.
+// El hilo de GL recoge los cambiados con TakeChanged y recompila lo que dependa de ellos
+struct ShaderWatcher
+{
+    explicit ShaderWatcher(std::chrono::milliseconds interval = std::chrono::milliseconds(500));
+    ~ShaderWatcher();
+
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+    void Watch(const std::string& path);
+
+    // Rutas modificadas desde la ultima llamada (sin repetidos)
+    std::vector<std::string> TakeChanged();
+
+private:
+    struct Entry
+    {
+        std::string path;
+        std::filesystem::file_time_type time;
+    };
+
+    void PollLoop();
+
+    std::chrono::milliseconds interval;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Entry> entries;
+    std::vector<std::string> changed;
+    bool stopping = false;
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "GameObject.hpp"
+
+// Vertice en bind pose con hasta 4 influencias (44 bytes, interleaved)
+struct SkinVertex
+{
+    float position[3] = { 0, 0, 0 };
+    float normal[3] = { 0, 0, 0 };
+    uint8_t joints[4] = { 0, 0, 0, 0 };
+    float weights[4] = { 1, 0, 0, 0 };
+};
+// SkinnedMesh::Init usa offsetof sobre este layout
+static_assert(sizeof(SkinVertex) == 44);
+
+// Linear: mezcla de matrices 3x4. DualQuat: mezcla de dual quats (sin efecto "candy wrapper",
+// solo para joints sin escala)
+enum class SkinningBlend { Linear, DualQuat };
+
+struct Skeleton
+{
+    // Limitado por los indices uint8_t y por el UBO de la paleta (256 * 48 bytes)
+    static constexpr std::size_t MaxJoints = 256;
+
+    // Los joints se anaden en orden padre -> hijo
+    std::vector<GameObject*> joints;
+    std::vector<int> parentIndex;
+    std::vector<Affine3> inverseBind;
+    std::vector<DualQuat> inverseBindDQ;
+
+    int AddJoint(GameObject* joint);
+
+    // Guarda la pose actual como bind pose (inversa de la global de cada joint)
+    void Bind();
+
+    // Paleta en espacio mundo: global * inverseBind, 3x4 row-major en float (12 floats por joint).
+    // origin se resta en double antes de pasar a float (dibujo relativo a la camara)
+    void ComputePalette(std::vector<float>& palette, const Vec3& origin = {}) const;
+
+    // Paleta de dual quats propagada sin matrices: 8 floats por joint, real y dual como (x, y, z, w)
+    void ComputeDualQuatPalette(std::vector<float>& palette, const Vec3& origin = {}) const;
+
+private:
+    mutable std::vector<Affine3> globals;
+    mutable std::vector<DualQuat> globalsDQ;
+};
+
+namespace Skinning {
+
+    // Escribe posicion + normal (6 floats) por vertice en out
+    void SkinVertices(const SkinVertex* in, std::size_t count, const float* palette, float* out);
+    void SkinVerticesScalar(const SkinVertex* in, std::size_t count, const float* palette, float* out);
+
+    // Igual pero con la paleta de ComputeDualQuatPalette (blending lineal de dual quats)
+    void SkinVerticesDualQuat(const SkinVertex* in, std::size_t count, const float* palette, float* out);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Formatos de textura que entiende el motor. Los comprimidos van en bloques de 4x4 texels
+// (BC1 y ETC2_RGB8: 8 bytes; BC3 y ETC2_RGBA8: 16 bytes, alfa primero)
+enum class TextureFormat { RGBA8, BC1_RGB, BC1_RGBA, BC3, ETC2_RGB8, ETC2_RGBA8 };
+
+// Textura en CPU con su cadena de mips completa
+struct ImageData
+{
+    int width = 0, height = 0; // del nivel 0
+    TextureFormat format = TextureFormat::RGBA8;
+    std::vector<std::vector<uint8_t>> levels; // nivel 0 = resolucion completa; la fila 0 es la de arriba
+
+    int LevelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+    int LevelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+    int LevelCount() const { return static_cast<int>(levels.size()); }
+};
+
+namespace TextureCodec
+{
+    // Bit de format en las mascaras de formatos soportados por la GPU
+    constexpr uint32_t Bit(TextureFormat format) { return 1u << static_cast<uint32_t>(format); }
+
+    bool IsCompressed(TextureFormat format);
+    // Bytes de un bloque de 4x4 (de un texel en RGBA8)
+    std::size_t BlockBytes(TextureFormat format);
+    std::size_t LevelBytes(TextureFormat format, int width, int height);
+
+    // KTX2 2D sin supercompresion (ni Basis ni zstd), RGBA8, BC1, BC3 o ETC2. Las variantes sRGB se
+    // leen como UNORM: el framebuffer no es sRGB y los colores se muestrean tal cual, como los PPM.
+    // Sin cadena de mips (levelCount 0) solo RGBA8: se genera con BuildMipChain
+    bool ParseKtx2(const std::string& bytes, ImageData& out, std::string& error);
+
+    // Completa la cadena de un RGBA8 de un solo nivel con un filtro de caja 2x2
+    void BuildMipChain(ImageData& image);
+
+    // Bloque comprimido -> 4x4 texels RGBA8 (16 * 4 bytes, fila a fila)
+    void DecodeBlock(TextureFormat format, const uint8_t* block, uint8_t* rgba);
+
+    // Descomprime todos los niveles a RGBA8 (fallback cuando la GPU no lee el formato)
+    void DecodeToRgba8(ImageData& image);
+}
\ No newline at end of file
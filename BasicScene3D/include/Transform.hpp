@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Matrix4x4.hpp"
+#include "Affine3.hpp"
 #include "Quat.hpp"
 #include "Matrix3x3.hpp"
 
@@ -15,7 +16,10 @@ struct Transform
     
     Vec3 eulerRotation{ 0.0, 0.0, 0.0 };
 
-    Matrix4x4 GetLocalMatrix() const;
+    Affine3 GetLocalMatrix() const;
 
     void SetEulerRotation(const Vec3& euler);
+
+    // Estado intermedio entre dos pasos de simulacion: lerp de posicion y escala, slerp de rotacion
+    static Transform Interpolate(const Transform& a, const Transform& b, double t);
 };
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "GameObject.hpp"
+#include "AssetManager.hpp"
+
+// Mundo partido en celdas cuadradas del plano XZ. Cada celda es una escena propia (cell_<x>_<z>.scene,
+// formato de AssetManager) y un indice (world.txt) da el tamano de celda y las celdas que existen.
+// Update pide a AssetManager las celdas cercanas a la camara y suelta las lejanas: la memoria depende
+// del radio de streaming, no del tamano del mundo
+struct WorldPartition
+{
+    struct Cell
+    {
+        int x = 0, z = 0;
+        AssetHandle scene;          // valido mientras se carga o esta cargada
+        GameObject* root = nullptr; // nodo "Cell x,z" colgado de sceneRoots
+        bool failed = false;        // no se vuelve a pedir
+    };
+
+    // Se carga lo que este a menos de loadRadius de la camara (distancia en XZ al cuadrado de la celda)
+    // y se suelta lo que pase de unloadRadius. Con unloadRadius > loadRadius una celda en el borde no
+    // entra y sale cada vez que la camara se mueve un poco
+    double loadRadius = 48.0;
+    double unloadRadius = 64.0;
+
+    // Lee el indice (sincrono: es pequeno). Si habia un mundo abierto hay que cerrarlo antes
+    bool Open(const std::string& indexPath, std::string& error);
+    bool IsOpen() const { return cellSize > 0.0; }
+
+    // Suelta todas las celdas; las que estaban colgadas salen como en Update
+    void Close(AssetManager& assets, std::vector<GameObject*>& sceneRoots, std::vector<GameObject*>& unloaded);
+
+    // Cada frame: pide las celdas que entran y quita de sceneRoots las que salen. Las quitadas van a
+    // unloaded: el que llama limpia sus referencias (seleccion, journal...) y las borra con DestroyTree.
+    // Solo recorre las celdas alrededor de la camara y las activas, no todo el indice
+    void Update(const Vec3& cameraPos, AssetManager& assets, std::vector<GameObject*>& sceneRoots, std::vector<GameObject*>& unloaded);
+
+    // Cuelga de sceneRoots las celdas que han llegado y las quita de arrived (lo demas no es del mundo).
+    // Devuelve cuantas
+    std::size_t Adopt(std::vector<LoadedAsset>& arrived, std::vector<GameObject*>& sceneRoots);
+
+    std::size_t CellCount() const { return cells.size(); }
+    std::size_t ActiveCount() const { return active.size(); }
+    std::size_t LoadedCount() const { return loaded; }
+
+    // Parte roots por la posicion global de cada raiz y escribe una escena por celda y el indice en dir.
+    // assetPath como en AssetManager::SerializeScene (relativa a dir)
+    static bool Export(const std::string& dir, double cellSize, const std::vector<GameObject*>& roots,
+                       const std::function<std::string(uint32_t)>& assetPath, std::string& error);
+
+    static std::string CellFileName(int x, int z);
+
+private:
+    static uint64_t Key(int x, int z) { return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z); }
+    double Distance(const Cell& cell, const Vec3& p) const;
+    void Unload(std::size_t index, AssetManager& assets, std::vector<GameObject*>& sceneRoots, std::vector<GameObject*>& unloaded);
+
+    std::string directory;
+    double cellSize = 0.0;
+    std::vector<Cell> cells;
+    std::unordered_map<uint64_t, std::size_t> byCoord;
+    std::unordered_map<uint32_t, std::size_t> byScene; // id de la escena de AssetManager -> celda
+    std::vector<std::size_t> active;                   // cargandose o cargadas
+    std::size_t loaded = 0;
+};
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include <GL/glew.h>
+#include "CommandBuffer.hpp"
+#include "GraphicsUtils.hpp"
+#include "IndirectRenderer.hpp"
+#include "MeshPool.hpp"
+
+// Backend GL de CommandBuffer: solo desde el hilo del contexto.
+// indirect / pool solo hacen falta si la lista tiene IndirectDraw
+inline void ReplayCommands(const CommandBuffer& commands, IndirectRenderer* indirect, const MeshPool* pool) {
+    static const char* const uniformNames[] = { "u_View", "u_Projection", "u_Model" };
+    GLuint program = 0;
+
+    commands.ForEach([&](const CommandBuffer::Command& cmd) {
+        switch (cmd.type) {
+        case CommandType::SetProgram:
+            program = cmd.As<CmdSetProgram>().program;
+            glUseProgram(program);
+            break;
+        case CommandType::SetMatrix: {
+            const CmdSetMatrix c = cmd.As<CmdSetMatrix>();
+            GLint loc = glGetUniformLocation(program, uniformNames[(int)c.slot]);
+            if (loc != -1) glUniformMatrix4fv(loc, 1, GL_TRUE, c.m);
+            break;
+        }
+        case CommandType::SetColor: {
+            const CmdSetColor c = cmd.As<CmdSetColor>();
+            GLint loc = glGetUniformLocation(program, "u_Color");
+            if (loc != -1) glUniform3fv(loc, 1, c.rgb);
+            break;
+        }
+        case CommandType::SetModel: {
+            const CmdSetModel c = cmd.As<CmdSetModel>();
+            for (int r = 0; r < 3; ++r)
+                glVertexAttrib4fv(INSTANCE_MODEL_LOCATION + r, c.model.m + r * 4);
+            break;
+        }
+        case CommandType::BindVertexArray:
+            glBindVertexArray(cmd.As<CmdBindVertexArray>().vao);
+            break;
+        case CommandType::BindTexture:
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, cmd.As<CmdBindTexture>().texture);
+            break;
+        case CommandType::BindUniformBuffer: {
+            const CmdBindUniformBuffer c = cmd.As<CmdBindUniformBuffer>();
+            glBindBufferBase(GL_UNIFORM_BUFFER, c.binding, c.buffer);
+            break;
+        }
+        case CommandType::UploadInstances: {
+            const CmdUploadInstances c = cmd.As<CmdUploadInstances>();
+            glBindBuffer(GL_ARRAY_BUFFER, c.buffer);
+            // Orphaning: evita esperar a que la GPU acabe con el frame anterior
+            glBufferData(GL_ARRAY_BUFFER, c.count * sizeof(Affine3f), nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, c.count * sizeof(Affine3f), cmd.Extra<CmdUploadInstances>());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            break;
+        }
+        case CommandType::DrawIndexed:
+            glDrawElements(GL_TRIANGLES, (GLsizei)cmd.As<CmdDrawIndexed>().indexCount, GL_UNSIGNED_INT, 0);
+            break;
+        case CommandType::DrawIndexedInstanced: {
+            const CmdDrawIndexedInstanced c = cmd.As<CmdDrawIndexedInstanced>();
+            glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)c.indexCount, GL_UNSIGNED_INT, 0, (GLsizei)c.instanceCount);
+            break;
+        }
+        case CommandType::IndirectDraw: {
+            const CmdIndirectDraw c = cmd.As<CmdIndirectDraw>();
+            indirect->AddDraw(pool->meshes[c.mesh], reinterpret_cast<const Affine3f*>(cmd.Extra<CmdIndirectDraw>()), c.count);
+            break;
+        }
+        case CommandType::IndirectFlush:
+            indirect->Flush();
+            break;
+        }
+    });
+}
\ No newline at end of file
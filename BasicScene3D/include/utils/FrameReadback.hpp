@@ -0,0 +1,76 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+// Lectura asincrona del color de un FBO con dos PBOs: glReadPixels del frame N va al PBO N % 2 y
+// vuelve enseguida (la copia la hace la GPU); lo que se mapea es el PBO del frame N - 1, que ya ha
+// tenido un frame entero para completarse. La salida va siempre un frame por detras
+struct FrameReadback {
+    GLuint pbo[2] = { 0, 0 };
+    GLsync fences[2] = { nullptr, nullptr };
+    int width = 0, height = 0;
+    int frame = 0;
+
+    void Init(int w, int h) {
+        width = w;
+        height = h;
+        if (pbo[0] == 0) glGenBuffers(2, pbo);
+        for (int i = 0; i < 2; ++i) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    // Encola la lectura de fbo y devuelve en out el frame anterior (false en el primero)
+    bool Capture(GLuint fbo, std::vector<uint8_t>& out) {
+        const int cur = frame & 1;
+        frame++;
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[cur]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        fences[cur] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        return Collect(cur ^ 1, out);
+    }
+
+    // Recoge la ultima lectura pendiente (al acabar)
+    bool Finish(std::vector<uint8_t>& out) {
+        return Collect((frame - 1) & 1, out);
+    }
+
+    void Shutdown() {
+        for (int i = 0; i < 2; ++i) {
+            if (fences[i]) glDeleteSync(fences[i]);
+            fences[i] = nullptr;
+        }
+        if (pbo[0]) glDeleteBuffers(2, pbo);
+        pbo[0] = pbo[1] = 0;
+    }
+
+private:
+    bool Collect(int i, std::vector<uint8_t>& out) {
+        if (!fences[i]) return false;
+
+        // Normalmente ya esta senalado; si no, se espera solo lo que falte de ese frame
+        while (glClientWaitSync(fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fences[i]);
+        fences[i] = nullptr;
+
+        const std::size_t size = (std::size_t)width * height * 4;
+        out.resize(size);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+        const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_READ_BIT);
+        if (data) {
+            std::memcpy(out.data(), data, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return data != nullptr;
+    }
+};
\ No newline at end of file
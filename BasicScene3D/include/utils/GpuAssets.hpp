@@ -0,0 +1,341 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include "Mesh.hpp"
+#include "MeshPool.hpp"
+#include "AssetManager.hpp"
+
+// Recursos de GL de los assets de AssetManager, por id. Lo que aun no esta subido resuelve al sustituto
+// (entrada 0: el cubo unidad; textura blanca de 1x1), asi que el que dibuja no distingue un asset
+// pendiente de uno listo. Se rellena solo en el hilo de GL con la simulacion parada. Lo soltado en
+// AssetManager deja de resolverse en el acto pero se borra RetireFrames llamadas despues: el frame que
+// se esta enviando se grabo antes y aun puede usar su VAO o su rango del MeshPool.
+// Las texturas guardan en CPU la cadena de mips entera (comprimida si la GPU la lee asi) y en GL solo
+// los niveles desde residentLevel: llegan con los de StreamStartSize texels o menos y StreamTextures
+// sube o baja niveles segun lo que ocupan en pantalla, sin pasar de textureBudgetBytes
+struct GpuAssets {
+    static constexpr int RetireFrames = 2;
+    static constexpr int StreamStartSize = 64;
+    // Frames seguidos con menos resolucion pedida de la que hay antes de soltar niveles (sin presion
+    // de memoria): evita subir y bajar el mismo nivel al acercarse y alejarse
+    static constexpr int ShrinkFrames = 120;
+
+    struct MeshEntry {
+        Mesh* mesh = nullptr;   // nullptr: sin subir
+        int poolMesh = -1;      // id en el MeshPool (-1 sin pool)
+        Vec3 halfExtents = { 0.5, 0.5, 0.5 };
+        // Copia en CPU para rasterizar la malla como oclusor (OcclusionCuller)
+        std::vector<float> positions;
+        std::vector<unsigned int> indices;
+    };
+
+    struct TextureEntry {
+        GLuint texture = 0;     // 0: sin subir
+        ImageData image;        // todos los niveles
+        int residentLevel = 0;  // nivel de image que es el 0 de texture
+        int wantedLevel = 0;
+        int shrinkFrames = 0;
+    };
+
+    std::vector<MeshEntry> meshes;       // por id de AssetManager
+    std::vector<TextureEntry> textures;  // por id
+    GLuint whiteTexture = 0;
+    std::size_t textureBudgetBytes = std::size_t(256) << 20;
+    std::size_t textureBytes = 0;        // niveles residentes de todas las texturas
+
+    // Escenas decodificadas en el ultimo Upload: el que llama adopta sus roots
+    std::vector<LoadedAsset> scenes;
+    // El ultimo Upload ha anadido o quitado mallas del MeshPool: GpuCuller tiene que rehacer sus comandos
+    bool poolChanged = false;
+
+    void Init(Mesh& cube, int cubePoolMesh) {
+        meshes.assign(1, MeshEntry());
+        meshes[0].mesh = &cube;
+        meshes[0].poolMesh = cubePoolMesh;
+        meshes[0].positions.assign(std::begin(Mesh::cubeVertices), std::end(Mesh::cubeVertices));
+        meshes[0].indices.assign(std::begin(Mesh::cubeIndices), std::end(Mesh::cubeIndices));
+
+        const uint8_t white[4] = { 255, 255, 255, 255 };
+        glGenTextures(1, &whiteTexture);
+        glBindTexture(GL_TEXTURE_2D, whiteTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // Formatos comprimidos que se suben tal cual (mascara para AssetManager::SetGpuTextureFormats).
+    // En escritorio ETC2 suele llegar por ARB_ES3_compatibility y el driver lo descomprime: ocupa como
+    // RGBA8 pero al menos no se descomprime aqui
+    static uint32_t SupportedTextureFormats() {
+        uint32_t formats = TextureCodec::Bit(TextureFormat::RGBA8);
+        if (GLEW_EXT_texture_compression_s3tc)
+            formats |= TextureCodec::Bit(TextureFormat::BC1_RGB) | TextureCodec::Bit(TextureFormat::BC1_RGBA) | TextureCodec::Bit(TextureFormat::BC3);
+        if (GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility)
+            formats |= TextureCodec::Bit(TextureFormat::ETC2_RGB8) | TextureCodec::Bit(TextureFormat::ETC2_RGBA8);
+        return formats;
+    }
+
+    const MeshEntry& MeshFor(uint32_t id) const {
+        return id < meshes.size() && meshes[id].mesh ? meshes[id] : meshes[0];
+    }
+
+    GLuint TextureFor(uint32_t id) const {
+        return id < textures.size() && textures[id].texture != 0 ? textures[id].texture : whiteTexture;
+    }
+
+    // Lado en texels del nivel 0 de una textura (0 si no esta subida): con el tamano en pantalla da el mip
+    int TextureSize(uint32_t id) const {
+        if (id >= textures.size() || textures[id].texture == 0) return 0;
+        return std::max(textures[id].image.width, textures[id].image.height);
+    }
+
+    // Sube lo decodificado hasta gastar budgetMs; al menos un asset por llamada para que la cola avance
+    // aunque uno solo se pase del presupuesto. pool != nullptr: las mallas van tambien al MeshPool
+    // (un solo Upload del pool al final, con los rangos nuevos). Devuelve cuantos assets se han subido o soltado
+    std::size_t Upload(AssetManager& assets, MeshPool* pool, double budgetMs) {
+        scenes.clear();
+        poolChanged = false;
+        const auto start = std::chrono::steady_clock::now();
+        std::size_t uploaded = 0;
+
+        for (std::size_t i = 0; i < retired.size();) {
+            if (--retired[i].frames > 0) {
+                ++i;
+                continue;
+            }
+            Free(retired[i], pool);
+            if (i + 1 != retired.size()) retired[i] = std::move(retired.back());
+            retired.pop_back();
+        }
+        for (AssetHandle handle : assets.TakeEvicted()) {
+            Retire(handle.id);
+            ++uploaded;
+        }
+        const std::size_t released = uploaded;
+
+        LoadedAsset asset;
+        while ((uploaded == released || std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < budgetMs) &&
+               assets.PopDecoded(asset)) {
+            const uint32_t id = asset.handle.id;
+            if (asset.type == AssetType::Scene) {
+                // Sin recursos de GL: las adopta el que llama
+                assets.MarkReady(asset);
+                scenes.push_back(std::move(asset));
+                ++uploaded;
+                continue;
+            }
+
+            if (asset.type == AssetType::Mesh) {
+                const MeshData& data = asset.mesh;
+                const int vertexCount = (int)(data.positions.size() / 3);
+                std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>();
+                mesh->Init(data.positions.data(), data.normals.data(), data.uvs.data(), vertexCount, data.indices.data(), (int)data.indices.size());
+
+                if (meshes.size() <= id) meshes.resize(id + 1);
+                // Soltada y pedida otra vez antes de ver el TakeEvicted
+                if (meshes[id].mesh) Retire(id);
+                MeshEntry& entry = meshes[id];
+                entry.mesh = mesh.get();
+                entry.halfExtents = data.halfExtents;
+                if (pool) {
+                    entry.poolMesh = pool->AddMesh(data.positions.data(), data.normals.data(), data.uvs.data(), vertexCount,
+                                                   data.indices.data(), (int)data.indices.size());
+                    poolChanged = true;
+                }
+                entry.positions = std::move(asset.mesh.positions);
+                entry.indices = std::move(asset.mesh.indices);
+                owned.push_back(std::move(mesh));
+            }
+            else {
+                if (textures.size() <= id) textures.resize(id + 1);
+                if (textures[id].texture != 0) Retire(id);
+                TextureEntry& entry = textures[id];
+                entry.image = std::move(asset.image);
+                entry.residentLevel = entry.wantedLevel = StartLevel(entry.image);
+                entry.texture = CreateTexture(entry.image, entry.residentLevel);
+                textureBytes += ResidentBytes(entry.image, entry.residentLevel);
+            }
+            // Soltado mientras se subia (p.ej. al descartar una escena en otro hilo): nadie lo ha visto
+            if (!assets.MarkReady(asset)) {
+                Retire(id);
+                retired.back().frames = 0;
+            }
+            ++uploaded;
+        }
+        if (pool) pool->Upload();
+        return uploaded;
+    }
+
+    // footprints: lado en pixels que ocupa en pantalla cada textura visible este frame (el maximo entre
+    // sus objetos). Primero se sueltan niveles que sobran y despues se suben los que faltan, los mas
+    // necesarios antes, hasta gastar budgetMs (al menos uno). Devuelve cuantas texturas han cambiado
+    std::size_t StreamTextures(const std::unordered_map<uint32_t, float>& footprints, double budgetMs) {
+        const auto start = std::chrono::steady_clock::now();
+        std::size_t changed = 0;
+
+        std::vector<uint32_t> grow;
+        for (uint32_t id = 0; id < textures.size(); ++id) {
+            TextureEntry& entry = textures[id];
+            if (entry.texture == 0) continue;
+            const auto it = footprints.find(id);
+            // No visible: se queda con los niveles de llegada
+            entry.wantedLevel = std::min(StartLevel(entry.image), it != footprints.end() ? LevelFor(entry.image, it->second) : entry.image.LevelCount());
+            if (entry.wantedLevel < entry.residentLevel) grow.push_back(id);
+            if (entry.wantedLevel <= entry.residentLevel) {
+                entry.shrinkFrames = 0;
+                continue;
+            }
+            if (++entry.shrinkFrames >= ShrinkFrames || textureBytes > textureBudgetBytes) {
+                SetResidentLevel(entry, entry.wantedLevel);
+                ++changed;
+            }
+        }
+
+        // Mas niveles por subir primero: es la que mas se nota borrosa
+        std::sort(grow.begin(), grow.end(), [&](uint32_t a, uint32_t b) {
+            return textures[a].residentLevel - textures[a].wantedLevel > textures[b].residentLevel - textures[b].wantedLevel;
+        });
+        for (std::size_t i = 0; i < grow.size(); ++i) {
+            if (i > 0 && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >= budgetMs) break;
+            TextureEntry& entry = textures[grow[i]];
+            // Sin sitio para todo lo pedido: lo mas fino que quepa
+            const std::size_t current = ResidentBytes(entry.image, entry.residentLevel);
+            int level = entry.wantedLevel;
+            while (level < entry.residentLevel && textureBytes - current + ResidentBytes(entry.image, level) > textureBudgetBytes) ++level;
+            if (level == entry.residentLevel) continue;
+            SetResidentLevel(entry, level);
+            ++changed;
+        }
+        return changed;
+    }
+
+    void Shutdown() {
+        for (Retired& r : retired) Free(r, nullptr);
+        retired.clear();
+        for (std::unique_ptr<Mesh>& mesh : owned) mesh->Release();
+        owned.clear();
+        for (TextureEntry& entry : textures)
+            if (entry.texture != 0) glDeleteTextures(1, &entry.texture);
+        textures.clear();
+        textureBytes = 0;
+        glDeleteTextures(1, &whiteTexture);
+        whiteTexture = 0;
+        meshes.clear();
+    }
+
+private:
+    struct Retired {
+        std::unique_ptr<Mesh> mesh;
+        int poolMesh = -1;
+        GLuint texture = 0;
+        int frames = RetireFrames;
+    };
+
+    // Deja de resolver el id; los recursos se borran en Free cuando ningun frame los usa
+    void Retire(uint32_t id) {
+        Retired r;
+        if (id < meshes.size() && meshes[id].mesh) {
+            for (std::size_t i = 0; i < owned.size(); ++i) {
+                if (owned[i].get() != meshes[id].mesh) continue;
+                r.mesh = std::move(owned[i]);
+                owned[i] = std::move(owned.back());
+                owned.pop_back();
+                break;
+            }
+            r.poolMesh = meshes[id].poolMesh;
+            meshes[id] = MeshEntry();
+        }
+        if (id < textures.size() && textures[id].texture != 0) {
+            r.texture = textures[id].texture;
+            textureBytes -= ResidentBytes(textures[id].image, textures[id].residentLevel);
+            textures[id] = TextureEntry();
+        }
+        retired.push_back(std::move(r));
+    }
+
+    // Nivel mas fino con StreamStartSize texels o menos de lado
+    static int StartLevel(const ImageData& image) {
+        int level = 0;
+        while (level + 1 < image.LevelCount() && std::max(image.LevelWidth(level), image.LevelHeight(level)) > StreamStartSize) ++level;
+        return level;
+    }
+
+    // Nivel mas pequeno que aun tiene al menos un texel por pixel a lo ancho de footprint pixels
+    static int LevelFor(const ImageData& image, float footprint) {
+        int level = 0;
+        while (level + 1 < image.LevelCount() && std::max(image.LevelWidth(level + 1), image.LevelHeight(level + 1)) >= footprint) ++level;
+        return level;
+    }
+
+    static std::size_t ResidentBytes(const ImageData& image, int firstLevel) {
+        std::size_t bytes = 0;
+        for (int level = firstLevel; level < image.LevelCount(); ++level)
+            bytes += image.levels[level].size();
+        return bytes;
+    }
+
+    static GLenum GlFormat(TextureFormat format) {
+        switch (format) {
+        case TextureFormat::BC1_RGB: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case TextureFormat::BC1_RGBA: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureFormat::ETC2_RGB8: return GL_COMPRESSED_RGB8_ETC2;
+        case TextureFormat::ETC2_RGBA8: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default: return GL_RGBA8;
+        }
+    }
+
+    // Textura de GL con los niveles [firstLevel, LevelCount) de image
+    static GLuint CreateTexture(const ImageData& image, int firstLevel) {
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        const GLenum format = GlFormat(image.format);
+        for (int level = firstLevel; level < image.LevelCount(); ++level) {
+            const std::vector<uint8_t>& data = image.levels[level];
+            // Sin voltear: t = 0 es la fila de arriba de la imagen
+            if (TextureCodec::IsCompressed(image.format))
+                glCompressedTexImage2D(GL_TEXTURE_2D, level - firstLevel, format, image.LevelWidth(level), image.LevelHeight(level), 0,
+                                       (GLsizei)data.size(), data.data());
+            else
+                glTexImage2D(GL_TEXTURE_2D, level - firstLevel, format, image.LevelWidth(level), image.LevelHeight(level), 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.LevelCount() - 1 - firstLevel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return tex;
+    }
+
+    // Sin texturas parciales en GL: se crea otra con los niveles nuevos y la vieja se retira (el frame
+    // en vuelo la puede estar usando). Los niveles gruesos se vuelven a subir; son un tercio del nuevo
+    void SetResidentLevel(TextureEntry& entry, int level) {
+        Retired r;
+        r.texture = entry.texture;
+        retired.push_back(std::move(r));
+        textureBytes -= ResidentBytes(entry.image, entry.residentLevel);
+        entry.texture = CreateTexture(entry.image, level);
+        entry.residentLevel = level;
+        entry.shrinkFrames = 0;
+        textureBytes += ResidentBytes(entry.image, level);
+    }
+
+    void Free(Retired& r, MeshPool* pool) {
+        if (r.mesh) r.mesh->Release();
+        if (pool && r.poolMesh >= 0) {
+            pool->RemoveMesh(r.poolMesh);
+            poolChanged = true;
+        }
+        if (r.texture != 0) glDeleteTextures(1, &r.texture);
+    }
+
+    std::vector<std::unique_ptr<Mesh>> owned;
+    std::vector<Retired> retired;
+};
\ No newline at end of file
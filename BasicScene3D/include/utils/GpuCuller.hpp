@@ -0,0 +1,198 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include "Ray.hpp"
+#include "MeshPool.hpp"
+#include "IndirectRenderer.hpp"
+#include "GraphicsUtils.hpp"
+
+// Instancia tal como la lee cull.comp.glsl (std430, 5 vec4): global 3x4 + AABB mundo
+struct GpuCullInstance {
+    Affine3f model;
+    float boundsMin[4] = { 0, 0, 0, 0 };
+    float boundsMax[4] = { 0, 0, 0, 0 };
+};
+static_assert(sizeof(GpuCullInstance) == 80);
+
+// Culling en compute (GL 4.3): las instancias se suben solo cuando cambia la escena; cada frame
+// cull.comp.glsl las prueba contra el frustum y contra el Hi-Z del frame anterior, copia las visibles
+// a la region de su malla y escribe instanceCount en los comandos indirectos. La CPU no toca los objetos
+struct GpuCuller {
+    GLuint cullProgram = 0, hizProgram = 0;
+    GLuint vao = 0;
+    GLuint instanceBuffer = 0, visibleBuffer = 0, commandBuffer = 0, meshIdBuffer = 0;
+    GLuint hiZ = 0;
+    int hiZWidth = 0, hiZHeight = 0, hiZLevels = 0;
+    bool hiZValid = false;
+
+    uint32_t instanceCount = 0;
+    std::vector<DrawElementsIndirectCommand> commandTemplate; // instanceCount = 0, se resetea cada frame
+
+    static bool Supported() { return GLEW_VERSION_4_3; }
+
+    // El VAO comparte vertices e indices con el pool; las locations 5-7 leen las instancias visibles
+    void Init(GLuint cullProg, GLuint hizProg, MeshPool& pool) {
+        cullProgram = cullProg;
+        hizProgram = hizProg;
+        pool.Upload();
+
+        glGenBuffers(1, &instanceBuffer);
+        glGenBuffers(1, &visibleBuffer);
+        glGenBuffers(1, &commandBuffer);
+        glGenBuffers(1, &meshIdBuffer);
+
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, pool.vbo);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, pool.nbo);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ARRAY_BUFFER, pool.uvbo);
+        glVertexAttribPointer(UV_LOCATION, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(UV_LOCATION);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.ebo);
+        glBindBuffer(GL_ARRAY_BUFFER, visibleBuffer);
+        for (int r = 0; r < 3; ++r) {
+            glVertexAttribPointer(INSTANCE_MODEL_LOCATION + r, 4, GL_FLOAT, GL_FALSE, sizeof(Affine3f), (void*)(r * 4 * sizeof(float)));
+            glEnableVertexAttribArray(INSTANCE_MODEL_LOCATION + r);
+            glVertexAttribDivisor(INSTANCE_MODEL_LOCATION + r, 1);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // Solo al cambiar la escena. meshIds[i] es la malla del pool de instances[i]
+    void Upload(const MeshPool& pool, const std::vector<GpuCullInstance>& instances, const std::vector<uint32_t>& meshIds) {
+        instanceCount = (uint32_t)instances.size();
+
+        // Cada malla tiene una region de visibles del tamano de todas sus instancias
+        std::vector<uint32_t> perMesh(pool.meshes.size(), 0);
+        for (uint32_t m : meshIds) ++perMesh[m];
+        commandTemplate.resize(pool.meshes.size());
+        uint32_t base = 0;
+        for (std::size_t m = 0; m < pool.meshes.size(); ++m) {
+            DrawElementsIndirectCommand& cmd = commandTemplate[m];
+            cmd.count = pool.meshes[m].indexCount;
+            cmd.instanceCount = 0;
+            cmd.firstIndex = pool.meshes[m].firstIndex;
+            cmd.baseVertex = pool.meshes[m].baseVertex;
+            cmd.baseInstance = base;
+            base += perMesh[m];
+        }
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, instances.size() * sizeof(GpuCullInstance), instances.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, meshIdBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, meshIds.size() * sizeof(uint32_t), meshIds.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<std::size_t>(instances.size(), 1) * sizeof(Affine3f), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, commandTemplate.size() * sizeof(DrawElementsIndirectCommand), commandTemplate.data(), GL_DYNAMIC_COPY);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    // viewProj para el frustum; prevViewProj es con la que se genero el Hi-Z (frame anterior)
+    void Cull(const Matrix4x4& viewProj, const Matrix4x4& prevViewProj) {
+        if (instanceCount == 0 || commandTemplate.empty()) return;
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandTemplate.size() * sizeof(DrawElementsIndirectCommand), commandTemplate.data());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        glUseProgram(cullProgram);
+
+        // Planos de Gribb-Hartmann (fila 3 +- filas 0..2); no hace falta normalizarlos para el test de signo
+        float planes[6][4];
+        for (int p = 0; p < 6; ++p) {
+            const int row = p / 2;
+            const double sign = (p % 2 == 0) ? 1.0 : -1.0;
+            for (int c = 0; c < 4; ++c)
+                planes[p][c] = (float)(viewProj.At(3, c) + sign * viewProj.At(row, c));
+        }
+        glUniform4fv(glGetUniformLocation(cullProgram, "u_Planes"), 6, &planes[0][0]);
+        glUniform1ui(glGetUniformLocation(cullProgram, "u_Count"), instanceCount);
+        GraphicsUtils::UploadMatrix4(cullProgram, "u_PrevViewProj", prevViewProj);
+
+        glUniform1i(glGetUniformLocation(cullProgram, "u_UseHiZ"), hiZValid ? 1 : 0);
+        glUniform2f(glGetUniformLocation(cullProgram, "u_HiZSize"), (float)hiZWidth, (float)hiZHeight);
+        glUniform1i(glGetUniformLocation(cullProgram, "u_HiZLevels"), hiZLevels);
+        glUniform1i(glGetUniformLocation(cullProgram, "u_HiZ"), 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, hiZ);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, visibleBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, meshIdBuffer);
+
+        glDispatchCompute((instanceCount + 63) / 64, 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // Programa de dibujo ya activo con view/projection subidas
+    void Draw() const {
+        if (instanceCount == 0 || commandTemplate.empty()) return;
+        glBindVertexArray(vao);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)commandTemplate.size(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    // Piramide de profundidad maxima a partir de la textura de profundidad del frame que acaba de dibujarse
+    void BuildHiZ(GLuint depthTexture, int width, int height) {
+        if (width <= 0 || height <= 0) return;
+        if (width != hiZWidth || height != hiZHeight) {
+            if (hiZ) glDeleteTextures(1, &hiZ);
+            hiZWidth = width;
+            hiZHeight = height;
+            hiZLevels = 1 + (int)std::floor(std::log2((double)std::max(width, height)));
+            glGenTextures(1, &hiZ);
+            glBindTexture(GL_TEXTURE_2D, hiZ);
+            glTexStorage2D(GL_TEXTURE_2D, hiZLevels, GL_R32F, width, height);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+
+        glUseProgram(hizProgram);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, depthTexture);
+        glUniform1i(glGetUniformLocation(hizProgram, "u_Depth"), 0);
+
+        int w = width, h = height;
+        for (int level = 0; level < hiZLevels; ++level) {
+            glUniform1i(glGetUniformLocation(hizProgram, "u_FirstLevel"), level == 0 ? 1 : 0);
+            glBindImageTexture(0, hiZ, level > 0 ? level - 1 : 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            glBindImageTexture(1, hiZ, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+            glDispatchCompute((w + 7) / 8, (h + 7) / 8, 1);
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            w = std::max(1, w / 2);
+            h = std::max(1, h / 2);
+        }
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        hiZValid = true;
+    }
+
+    void Shutdown() {
+        glDeleteBuffers(1, &instanceBuffer);
+        glDeleteBuffers(1, &visibleBuffer);
+        glDeleteBuffers(1, &commandBuffer);
+        glDeleteBuffers(1, &meshIdBuffer);
+        glDeleteVertexArrays(1, &vao);
+        if (hiZ) glDeleteTextures(1, &hiZ);
+        instanceBuffer = visibleBuffer = commandBuffer = meshIdBuffer = vao = hiZ = 0;
+        hiZValid = false;
+    }
+};
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <GL/glew.h>
 #include <vector>
 #include "Matrix4x4.hpp"
+#include "Affine3.hpp"
+#include "Mesh.hpp"
 
 namespace GraphicsUtils {
 
@@ -23,6 +25,13 @@ namespace GraphicsUtils {
         UploadMatrix4(programId, "u_Projection", proj);
     }
 
+    // Draws sin buffer de instancias: la global va como valor constante de las locations 5-7
+    inline void SetModelAttribute(const Affine3& model) {
+        const Affine3f f(model);
+        for (int r = 0; r < 3; ++r)
+            glVertexAttrib4fv(INSTANCE_MODEL_LOCATION + r, f.m + r * 4);
+    }
+
     inline void UploadColor(GLuint programId, const Vec3& vec) {
         GLint loc = glGetUniformLocation(programId, "u_Color");
         if (loc == -1) return;
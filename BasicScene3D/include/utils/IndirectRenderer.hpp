@@ -0,0 +1,158 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include "Affine3.hpp"
+#include "MeshPool.hpp"
+
+// Layout fijado por GL para GL_DRAW_INDIRECT_BUFFER
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// Camino GPU-driven: instancias y comandos en buffers persistentes triple-buffer (una region por frame
+// en vuelo, protegida con un fence) y un glMultiDrawElementsIndirect por lote.
+// Necesita GL 4.3 + ARB_buffer_storage (Mesa llvmpipe da 4.5); si no, se usa la cola normal
+struct IndirectRenderer {
+    static constexpr int FrameCount = 3;
+
+    GLuint instanceBuffer = 0, commandBuffer = 0;
+    Affine3f* instances = nullptr;
+    DrawElementsIndirectCommand* commands = nullptr;
+    GLsync fences[FrameCount] = { nullptr, nullptr, nullptr };
+
+    uint32_t instanceCapacity = 0, commandCapacity = 0; // por frame
+    uint32_t instanceCount = 0, commandCount = 0;       // del frame actual
+    uint32_t batchStart = 0;                            // primer comando del lote sin enviar
+    int frame = 0;
+
+    static bool Supported() {
+        return (GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance)) &&
+               (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage);
+    }
+
+    // Enlaza el buffer de instancias a las locations 5-7 del VAO del pool
+    void Init(MeshPool& pool, uint32_t maxInstances, uint32_t maxCommands) {
+        pool.Upload();
+        Allocate(maxInstances, maxCommands);
+        AttachInstances(pool);
+    }
+
+    // Espera a que la GPU suelte la region de este frame antes de escribir en ella
+    void BeginFrame(MeshPool& pool, uint32_t neededInstances, uint32_t neededCommands) {
+        WaitFence(frame);
+        if (neededInstances > instanceCapacity || neededCommands > commandCapacity) {
+            for (int f = 0; f < FrameCount; ++f) WaitFence(f);
+            Release();
+            Allocate(Grow(instanceCapacity, neededInstances), Grow(commandCapacity, neededCommands));
+            AttachInstances(pool);
+        }
+        instanceCount = commandCount = batchStart = 0;
+    }
+
+    // Copia las globales y anade un comando; baseInstance apunta a su sitio en la region del frame
+    void AddDraw(const MeshPool::Range& mesh, const Affine3f* models, uint32_t count) {
+        if (count == 0) return;
+        const uint32_t base = frame * instanceCapacity + instanceCount;
+        for (uint32_t i = 0; i < count; ++i) instances[base + i] = models[i];
+
+        DrawElementsIndirectCommand& cmd = commands[frame * commandCapacity + commandCount];
+        cmd.count = mesh.indexCount;
+        cmd.instanceCount = count;
+        cmd.firstIndex = mesh.firstIndex;
+        cmd.baseVertex = mesh.baseVertex;
+        cmd.baseInstance = base;
+
+        instanceCount += count;
+        ++commandCount;
+    }
+
+    // Un glMultiDrawElementsIndirect con los comandos anadidos desde el ultimo Flush (VAO del pool enlazado)
+    void Flush() {
+        const uint32_t n = commandCount - batchStart;
+        if (n == 0) return;
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        const std::size_t offset = (frame * commandCapacity + batchStart) * sizeof(DrawElementsIndirectCommand);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)offset, (GLsizei)n, 0);
+        batchStart = commandCount;
+    }
+
+    void EndFrame() {
+        fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        frame = (frame + 1) % FrameCount;
+    }
+
+    void Shutdown() {
+        for (int f = 0; f < FrameCount; ++f) WaitFence(f);
+        Release();
+    }
+
+private:
+    static uint32_t Grow(uint32_t current, uint32_t needed) {
+        uint32_t c = current > 0 ? current : 64;
+        while (c < needed) c *= 2;
+        return c;
+    }
+
+    void WaitFence(int f) {
+        if (!fences[f]) return;
+        // El primer intento vacia el pipeline; despues se espera de 1 ms en 1 ms
+        GLenum r = glClientWaitSync(fences[f], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (r == GL_TIMEOUT_EXPIRED) r = glClientWaitSync(fences[f], 0, 1000000);
+        glDeleteSync(fences[f]);
+        fences[f] = nullptr;
+    }
+
+    void Allocate(uint32_t maxInstances, uint32_t maxCommands) {
+        instanceCapacity = maxInstances;
+        commandCapacity = maxCommands;
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        const GLsizeiptr instanceBytes = (GLsizeiptr)FrameCount * instanceCapacity * sizeof(Affine3f);
+        glGenBuffers(1, &instanceBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferStorage(GL_ARRAY_BUFFER, instanceBytes, nullptr, flags);
+        instances = (Affine3f*)glMapBufferRange(GL_ARRAY_BUFFER, 0, instanceBytes, flags);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        const GLsizeiptr commandBytes = (GLsizeiptr)FrameCount * commandCapacity * sizeof(DrawElementsIndirectCommand);
+        glGenBuffers(1, &commandBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferStorage(GL_DRAW_INDIRECT_BUFFER, commandBytes, nullptr, flags);
+        commands = (DrawElementsIndirectCommand*)glMapBufferRange(GL_DRAW_INDIRECT_BUFFER, 0, commandBytes, flags);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void Release() {
+        if (instanceBuffer) {
+            glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDeleteBuffers(1, &instanceBuffer);
+        }
+        if (commandBuffer) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+            glUnmapBuffer(GL_DRAW_INDIRECT_BUFFER);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+            glDeleteBuffers(1, &commandBuffer);
+        }
+        instanceBuffer = commandBuffer = 0;
+        instances = nullptr;
+        commands = nullptr;
+    }
+
+    void AttachInstances(MeshPool& pool) {
+        glBindVertexArray(pool.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        for (int r = 0; r < 3; ++r) {
+            glVertexAttribPointer(INSTANCE_MODEL_LOCATION + r, 4, GL_FLOAT, GL_FALSE, sizeof(Affine3f), (void*)(r * 4 * sizeof(float)));
+            glEnableVertexAttribArray(INSTANCE_MODEL_LOCATION + r);
+            glVertexAttribDivisor(INSTANCE_MODEL_LOCATION + r, 1);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include "LightClusters.hpp"
+
+// Unidades de textura y binding del bloque ClusterParams de las variantes CLUSTERED de fs.glsl.
+// La unidad 0 queda para las texturas del material
+#define CLUSTER_LIGHTS_UNIT 1
+#define CLUSTER_GRID_UNIT 2
+#define CLUSTER_INDICES_UNIT 3
+#define CLUSTER_PARAMS_BINDING 1
+
+// Sube las listas de LightClusters a buffers de textura (GL 3.1): luces (RGBA32F, 3 texels por luz),
+// rejilla (RG32UI, offset y cuenta por cluster) e indices (R32UI), mas un UBO con las dimensiones
+struct LightBuffers {
+    enum { Lights, Grid, Indices, Count };
+
+    GLuint buffers[Count] = { 0, 0, 0 };
+    GLuint textures[Count] = { 0, 0, 0 };
+    GLuint params = 0;
+
+    // Texels que admite cada buffer de textura; LightClusters no debe producir mas
+    static GLint MaxTexels() {
+        GLint texels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &texels);
+        return texels;
+    }
+
+    void Init() {
+        const GLenum formats[Count] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+        glGenBuffers(Count, buffers);
+        glGenTextures(Count, textures);
+        for (int i = 0; i < Count; ++i) {
+            // Un buffer vacio no se puede enlazar a la textura: se reserva un texel
+            glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+            glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+            glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+        }
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        glGenBuffers(1, &params);
+        glBindBuffer(GL_UNIFORM_BUFFER, params);
+        glBufferData(GL_UNIFORM_BUFFER, 8 * sizeof(float), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    // Una vez por frame antes de dibujar; deja todo enlazado
+    void Upload(const LightClusters& clusters, int viewportWidth, int viewportHeight) {
+        Fill(Lights, clusters.Lights().data(), clusters.Lights().size() * sizeof(LightClusters::GpuLight));
+        Fill(Grid, clusters.Grid().data(), clusters.Grid().size() * sizeof(uint32_t));
+        Fill(Indices, clusters.Indices().data(), clusters.Indices().size() * sizeof(uint32_t));
+
+        // std140: uvec4 dimensiones, vec4 (tiles por pixel en x e y, escala y sesgo del slice)
+        struct {
+            uint32_t dims[4];
+            float scale[4];
+        } block = {
+            { LightClusters::DimX, LightClusters::DimY, LightClusters::DimZ, (uint32_t)clusters.Lights().size() },
+            { (float)LightClusters::DimX / viewportWidth, (float)LightClusters::DimY / viewportHeight,
+              clusters.DepthScale(), clusters.DepthBias() }
+        };
+        glBindBuffer(GL_UNIFORM_BUFFER, params);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        Bind();
+    }
+
+    void Bind() const {
+        const GLenum units[Count] = { CLUSTER_LIGHTS_UNIT, CLUSTER_GRID_UNIT, CLUSTER_INDICES_UNIT };
+        for (int i = 0; i < Count; ++i) {
+            glActiveTexture(GL_TEXTURE0 + units[i]);
+            glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, CLUSTER_PARAMS_BINDING, params);
+    }
+
+    // Estado por programa que no se guarda en el binario: samplers y bloque
+    static void SetupProgram(GLuint program) {
+        GLuint blockIndex = glGetUniformBlockIndex(program, "ClusterParams");
+        if (blockIndex == GL_INVALID_INDEX) return;
+        glUniformBlockBinding(program, blockIndex, CLUSTER_PARAMS_BINDING);
+
+        GLint previous = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &previous);
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "u_Lights"), CLUSTER_LIGHTS_UNIT);
+        glUniform1i(glGetUniformLocation(program, "u_ClusterGrid"), CLUSTER_GRID_UNIT);
+        glUniform1i(glGetUniformLocation(program, "u_LightIndices"), CLUSTER_INDICES_UNIT);
+        glUseProgram(previous);
+    }
+
+    void Shutdown() {
+        glDeleteTextures(Count, textures);
+        glDeleteBuffers(Count, buffers);
+        glDeleteBuffers(1, &params);
+        for (int i = 0; i < Count; ++i) buffers[i] = textures[i] = 0;
+        params = 0;
+    }
+
+private:
+    void Fill(int which, const void* data, std::size_t size) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffers[which]);
+        // Orphaning; nunca vacio (la textura necesita almacenamiento)
+        glBufferData(GL_TEXTURE_BUFFER, size > 0 ? size : 16, size > 0 ? data : nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+};
\ No newline at end of file
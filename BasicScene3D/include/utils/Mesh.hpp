@@ -1,90 +1,188 @@
 #pragma once
 #include <GL/glew.h>
 #include <vector>
+#include "Affine3.hpp"
+
+// Location 2: coordenadas de textura (vec2)
+#define UV_LOCATION 2
+// Locations 5-7: filas de la global por instancia (mat3x4 en vs.glsl)
+#define INSTANCE_MODEL_LOCATION 5
 
 struct Mesh {
-    GLuint vao = 0, vbo = 0, ebo = 0;
+    GLuint vao = 0, vbo = 0, nbo = 0, uvbo = 0, ebo = 0, instanceVbo = 0;
     int indexCount = 0;
 
+    // Datos del cubo unidad; tambien los usa MeshPool
+    static constexpr float cubeVertices[] = {
+        // Front Face (Z+)
+        -0.5f, -0.5f,  0.5f, // 0 BL
+         0.5f, -0.5f,  0.5f, // 1 BR
+         0.5f,  0.5f,  0.5f, // 2 TR
+        -0.5f,  0.5f,  0.5f, // 3 TL
+
+        // Back Face (Z-)
+         0.5f, -0.5f, -0.5f, // 4 BR
+        -0.5f, -0.5f, -0.5f, // 5 BL
+        -0.5f,  0.5f, -0.5f, // 6 TL
+         0.5f,  0.5f, -0.5f, // 7 TR
+
+         // Right Face (X+)
+          0.5f, -0.5f,  0.5f, // 8  Front-Bottom
+          0.5f, -0.5f, -0.5f, // 9  Back-Bottom
+          0.5f,  0.5f, -0.5f, // 10 Back-Top
+          0.5f,  0.5f,  0.5f, // 11 Front-Top
+
+          // Left Face (X-)
+          -0.5f, -0.5f, -0.5f, // 12 Back-Bottom
+          -0.5f, -0.5f,  0.5f, // 13 Front-Bottom
+          -0.5f,  0.5f,  0.5f, // 14 Front-Top
+          -0.5f,  0.5f, -0.5f, // 15 Back-Top
+
+          // Top Face (Y+)
+          -0.5f,  0.5f,  0.5f, // 16 Front-Left
+           0.5f,  0.5f,  0.5f, // 17 Front-Right
+           0.5f,  0.5f, -0.5f, // 18 Back-Right
+          -0.5f,  0.5f, -0.5f, // 19 Back-Left
+
+          // Bottom Face (Y-)
+          -0.5f, -0.5f, -0.5f, // 20 Back-Left
+           0.5f, -0.5f, -0.5f, // 21 Back-Right
+           0.5f, -0.5f,  0.5f, // 22 Front-Right
+          -0.5f, -0.5f,  0.5f  // 23 Front-Left
+    };
+
+    static constexpr unsigned int cubeIndices[] = {
+        // Front
+        0, 1, 2, 2, 3, 0,
+        // Back
+        4, 5, 6, 6, 7, 4,
+        // Right
+        8, 9, 10, 10, 11, 8,
+        // Left
+        12, 13, 14, 14, 15, 12,
+        // Top
+        16, 17, 18, 18, 19, 16,
+        // Bottom
+        20, 21, 22, 22, 23, 20
+    };
+
+    // Normal de cada vertice de cubeVertices (una por cara)
+    static constexpr float cubeNormals[] = {
+         0,  0,  1,   0,  0,  1,   0,  0,  1,   0,  0,  1,
+         0,  0, -1,   0,  0, -1,   0,  0, -1,   0,  0, -1,
+         1,  0,  0,   1,  0,  0,   1,  0,  0,   1,  0,  0,
+        -1,  0,  0,  -1,  0,  0,  -1,  0,  0,  -1,  0,  0,
+         0,  1,  0,   0,  1,  0,   0,  1,  0,   0,  1,  0,
+         0, -1,  0,   0, -1,  0,   0, -1,  0,   0, -1,  0
+    };
+    static_assert(sizeof(cubeNormals) == sizeof(cubeVertices));
+
+    // La imagen entera en cada cara (t = 0 arriba)
+    static constexpr float cubeUVs[] = {
+        0, 1,  1, 1,  1, 0,  0, 0,
+        0, 1,  1, 1,  1, 0,  0, 0,
+        0, 1,  1, 1,  1, 0,  0, 0,
+        0, 1,  1, 1,  1, 0,  0, 0,
+        0, 1,  1, 1,  1, 0,  0, 0,
+        0, 1,  1, 1,  1, 0,  0, 0
+    };
+    static_assert(sizeof(cubeUVs) * 3 == sizeof(cubeVertices) * 2);
+
     void InitCube() {
-        float vertices[] = {
-            // Front Face (Z+)
-            -0.5f, -0.5f,  0.5f, // 0 BL
-             0.5f, -0.5f,  0.5f, // 1 BR
-             0.5f,  0.5f,  0.5f, // 2 TR
-            -0.5f,  0.5f,  0.5f, // 3 TL
-
-            // Back Face (Z-)
-             0.5f, -0.5f, -0.5f, // 4 BR
-            -0.5f, -0.5f, -0.5f, // 5 BL
-            -0.5f,  0.5f, -0.5f, // 6 TL
-             0.5f,  0.5f, -0.5f, // 7 TR
-
-             // Right Face (X+)
-              0.5f, -0.5f,  0.5f, // 8  Front-Bottom
-              0.5f, -0.5f, -0.5f, // 9  Back-Bottom
-              0.5f,  0.5f, -0.5f, // 10 Back-Top
-              0.5f,  0.5f,  0.5f, // 11 Front-Top
-
-              // Left Face (X-)
-              -0.5f, -0.5f, -0.5f, // 12 Back-Bottom
-              -0.5f, -0.5f,  0.5f, // 13 Front-Bottom
-              -0.5f,  0.5f,  0.5f, // 14 Front-Top
-              -0.5f,  0.5f, -0.5f, // 15 Back-Top
-
-              // Top Face (Y+)
-              -0.5f,  0.5f,  0.5f, // 16 Front-Left
-               0.5f,  0.5f,  0.5f, // 17 Front-Right
-               0.5f,  0.5f, -0.5f, // 18 Back-Right
-              -0.5f,  0.5f, -0.5f, // 19 Back-Left
-
-              // Bottom Face (Y-)
-              -0.5f, -0.5f, -0.5f, // 20 Back-Left
-               0.5f, -0.5f, -0.5f, // 21 Back-Right
-               0.5f, -0.5f,  0.5f, // 22 Front-Right
-              -0.5f, -0.5f,  0.5f  // 23 Front-Left
-        };
-
-        unsigned int indices[] = {
-            // Front
-            0, 1, 2, 2, 3, 0,
-            // Back
-            4, 5, 6, 6, 7, 4,
-            // Right
-            8, 9, 10, 10, 11, 8,
-            // Left
-            12, 13, 14, 14, 15, 12,
-            // Top
-            16, 17, 18, 18, 19, 16,
-            // Bottom
-            20, 21, 22, 22, 23, 20
-        };
-
-        indexCount = 36; // 6 cares * 2 triangles * 3 vrtexs
+        // 6 cares * 2 triangles * 3 vrtexs
+        Init(cubeVertices, cubeNormals, cubeUVs, (int)(sizeof(cubeVertices) / (3 * sizeof(float))), cubeIndices, 36);
+    }
+
+    // Malla cualquiera (p.ej. de AssetManager): 3 floats de posicion, 3 de normal y 2 de UV por vertice
+    void Init(const float* positions, const float* normals, const float* uvs, int vertexCount, const unsigned int* indices, int count) {
+        indexCount = count;
 
         if (vao == 0) glGenVertexArrays(1, &vao);
         if (vbo == 0) glGenBuffers(1, &vbo);
+        if (nbo == 0) glGenBuffers(1, &nbo);
+        if (uvbo == 0) glGenBuffers(1, &uvbo);
         if (ebo == 0) glGenBuffers(1, &ebo);
 
         glBindVertexArray(vao);
 
         glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * 3 * sizeof(float), positions, GL_STATIC_DRAW);
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
 
         // Posici (location = 0, 3 floats)
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(0);
 
+        // Normal (location = 1, 3 floats)
+        glBindBuffer(GL_ARRAY_BUFFER, nbo);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * 3 * sizeof(float), normals, GL_STATIC_DRAW);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+
+        // UV (location = 2, 2 floats)
+        glBindBuffer(GL_ARRAY_BUFFER, uvbo);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * 2 * sizeof(float), uvs, GL_STATIC_DRAW);
+        glVertexAttribPointer(UV_LOCATION, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(UV_LOCATION);
+
+        // Instancias: una global 3x4 por instancia, se rellena en UploadInstances
+        if (instanceVbo == 0) glGenBuffers(1, &instanceVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        for (int r = 0; r < 3; ++r) {
+            glVertexAttribPointer(INSTANCE_MODEL_LOCATION + r, 4, GL_FLOAT, GL_FALSE, sizeof(Affine3f), (void*)(r * 4 * sizeof(float)));
+            glEnableVertexAttribArray(INSTANCE_MODEL_LOCATION + r);
+            glVertexAttribDivisor(INSTANCE_MODEL_LOCATION + r, 1);
+        }
+
         glBindVertexArray(0);
     }
 
-    void Draw() {
+    // Bind / DrawBound separados para que el que envia los draws solo cambie el VAO cuando haga falta
+    void Bind() {
         if (vao == 0) InitCube();
         glBindVertexArray(vao);
+    }
+
+    void DrawBound() const {
         glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    }
+
+    // No toca el VAO: el buffer de instancias ya esta enlazado a las locations 5-7
+    void UploadInstances(const Affine3f* models, int count) {
+        if (vao == 0) InitCube();
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+        // Orphaning: evita esperar a que la GPU acabe con el frame anterior
+        glBufferData(GL_ARRAY_BUFFER, count * sizeof(Affine3f), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(Affine3f), models);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void DrawBoundInstanced(int count) const {
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, count);
+    }
+
+    void Draw() {
+        Bind();
+        DrawBound();
         glBindVertexArray(0);
     }
+
+    // Un draw para todas las instancias; models se sube tal cual (48 bytes por instancia)
+    void DrawInstanced(const Affine3f* models, int count) {
+        if (count <= 0) return;
+        UploadInstances(models, count);
+        Bind();
+        DrawBoundInstanced(count);
+        glBindVertexArray(0);
+    }
+
+    void Release() {
+        glDeleteVertexArrays(1, &vao);
+        GLuint buffers[] = { vbo, nbo, uvbo, ebo, instanceVbo };
+        glDeleteBuffers(5, buffers);
+        vao = vbo = nbo = uvbo = ebo = instanceVbo = 0;
+        indexCount = 0;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <algorithm>
+#include "Mesh.hpp"
+
+// Todas las mallas en un VBO/EBO compartidos: un solo VAO para todo el camino indirecto.
+// Cada malla es un rango (firstIndex, indexCount, baseVertex) de los buffers. Los rangos no se mueven:
+// RemoveMesh deja un hueco que reutiliza el siguiente AddMesh que quepa, y Upload solo sube lo escrito
+// desde el anterior (los buffers se recrean solo al crecer)
+struct MeshPool {
+    struct Range {
+        GLuint firstIndex = 0;
+        GLuint indexCount = 0;
+        GLint baseVertex = 0;
+        GLuint vertexCount = 0;
+    };
+
+    GLuint vao = 0, vbo = 0, nbo = 0, uvbo = 0, ebo = 0;
+    std::vector<Range> meshes;
+    std::vector<int> freeIds; // ids de RemoveMesh, los reutiliza AddMesh
+
+    std::vector<float> positions;      // 3 floats por vertice (location 0)
+    std::vector<float> normals;        // 3 floats por vertice (location 1)
+    std::vector<float> uvs;            // 2 floats por vertice (location 2)
+    std::vector<unsigned int> indices; // relativos a baseVertex de su malla
+
+    // Devuelve el id de la malla; los datos se suben en el siguiente Upload
+    int AddMesh(const float* pos, const float* nrm, const float* uv, int vertexCount, const unsigned int* idx, int indexCount) {
+        Range r;
+        r.indexCount = (GLuint)indexCount;
+        r.vertexCount = (GLuint)vertexCount;
+        r.baseVertex = (GLint)Allocate(freeVertices, r.vertexCount, positions.size() / 3);
+        r.firstIndex = Allocate(freeIndices, r.indexCount, indices.size());
+
+        const std::size_t vertexEnd = (std::size_t)r.baseVertex + r.vertexCount;
+        if (vertexEnd * 3 > positions.size()) {
+            positions.resize(vertexEnd * 3);
+            normals.resize(vertexEnd * 3);
+            uvs.resize(vertexEnd * 2);
+        }
+        if ((std::size_t)r.firstIndex + r.indexCount > indices.size()) indices.resize((std::size_t)r.firstIndex + r.indexCount);
+        std::copy(pos, pos + vertexCount * 3, positions.begin() + r.baseVertex * 3);
+        std::copy(nrm, nrm + vertexCount * 3, normals.begin() + r.baseVertex * 3);
+        std::copy(uv, uv + vertexCount * 2, uvs.begin() + r.baseVertex * 2);
+        std::copy(idx, idx + indexCount, indices.begin() + r.firstIndex);
+        dirtyVertices.push_back({ (GLuint)r.baseVertex, r.vertexCount });
+        dirtyIndices.push_back({ r.firstIndex, r.indexCount });
+
+        if (!freeIds.empty()) {
+            const int id = freeIds.back();
+            freeIds.pop_back();
+            meshes[id] = r;
+            return id;
+        }
+        meshes.push_back(r);
+        return (int)meshes.size() - 1;
+    }
+
+    // O(huecos): no toca los datos de las demas mallas ni la GPU. No se puede quitar una malla que use
+    // un frame aun sin enviar: el que llama espera a que acabe
+    void RemoveMesh(int id) {
+        const Range r = meshes[id];
+        Release(freeVertices, (GLuint)r.baseVertex, r.vertexCount);
+        Release(freeIndices, r.firstIndex, r.indexCount);
+        meshes[id] = Range();
+        freeIds.push_back(id);
+    }
+
+    int AddCube() {
+        return AddMesh(Mesh::cubeVertices, Mesh::cubeNormals, Mesh::cubeUVs, (int)(sizeof(Mesh::cubeVertices) / (3 * sizeof(float))),
+                       Mesh::cubeIndices, (int)(sizeof(Mesh::cubeIndices) / sizeof(unsigned int)));
+    }
+
+    void Upload() {
+        if (vao == 0) CreateBuffers();
+        if (dirtyVertices.empty() && dirtyIndices.empty()) return;
+
+        // Sin sitio: el doble y se sube todo (amortizado); si no, solo los rangos escritos
+        const std::size_t vertexCount = positions.size() / 3;
+        if (vertexCount > vertexCapacity) {
+            vertexCapacity = std::max(vertexCount, vertexCapacity * 2);
+            Reserve(vbo, vertexCapacity * 3 * sizeof(float));
+            Reserve(nbo, vertexCapacity * 3 * sizeof(float));
+            Reserve(uvbo, vertexCapacity * 2 * sizeof(float));
+            dirtyVertices.assign(1, { 0, (GLuint)vertexCount });
+        }
+        if (indices.size() > indexCapacity) {
+            indexCapacity = std::max(indices.size(), indexCapacity * 2);
+            Reserve(ebo, indexCapacity * sizeof(unsigned int));
+            dirtyIndices.assign(1, { 0, (GLuint)indices.size() });
+        }
+
+        for (const Span& span : dirtyVertices) {
+            Write(vbo, positions.data(), span, 3);
+            Write(nbo, normals.data(), span, 3);
+            Write(uvbo, uvs.data(), span, 2);
+        }
+        for (const Span& span : dirtyIndices) Write(ebo, indices.data(), span, 1);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        dirtyVertices.clear();
+        dirtyIndices.clear();
+    }
+
+private:
+    struct Span {
+        GLuint first = 0;
+        GLuint count = 0;
+    };
+
+    std::vector<Span> freeVertices, freeIndices; // huecos ordenados por first, sin adyacentes
+    std::vector<Span> dirtyVertices, dirtyIndices;
+    std::size_t vertexCapacity = 0, indexCapacity = 0;
+
+    // Primer hueco donde quepa; si no hay, al final (end)
+    static GLuint Allocate(std::vector<Span>& free, GLuint count, std::size_t end) {
+        if (count == 0) return (GLuint)end;
+        for (std::size_t i = 0; i < free.size(); ++i) {
+            if (free[i].count < count) continue;
+            const GLuint first = free[i].first;
+            free[i].first += count;
+            free[i].count -= count;
+            if (free[i].count == 0) free.erase(free.begin() + i);
+            return first;
+        }
+        return (GLuint)end;
+    }
+
+    // Devuelve un rango a los huecos, juntandolo con los vecinos
+    static void Release(std::vector<Span>& free, GLuint first, GLuint count) {
+        if (count == 0) return;
+        auto it = std::lower_bound(free.begin(), free.end(), first, [](const Span& s, GLuint f) { return s.first < f; });
+        if (it != free.begin() && (it - 1)->first + (it - 1)->count == first) {
+            --it;
+            it->count += count;
+        }
+        else {
+            it = free.insert(it, { first, count });
+        }
+        if (it + 1 != free.end() && it->first + it->count == (it + 1)->first) {
+            it->count += (it + 1)->count;
+            free.erase(it + 1);
+        }
+    }
+
+    void CreateBuffers() {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &nbo);
+        glGenBuffers(1, &uvbo);
+        glGenBuffers(1, &ebo);
+
+        // Los punteros se quedan: recrear el almacenamiento de un buffer no cambia su nombre
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, nbo);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ARRAY_BUFFER, uvbo);
+        glVertexAttribPointer(UV_LOCATION, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(UV_LOCATION);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // GL_COPY_WRITE_BUFFER: no toca el EBO del VAO que este enlazado
+    static void Reserve(GLuint buffer, std::size_t bytes) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+    }
+
+    template <typename T>
+    static void Write(GLuint buffer, const T* data, const Span& span, int components) {
+        if (span.count == 0) return;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)span.first * components * sizeof(T), (GLsizeiptr)span.count * components * sizeof(T),
+                        data + (std::size_t)span.first * components);
+    }
+};
\ No newline at end of file
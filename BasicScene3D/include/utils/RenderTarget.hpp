@@ -0,0 +1,59 @@
+#pragma once
+#include <GL/glew.h>
+
+// FBO de la escena: color en renderbuffer y profundidad en textura (la lee el Hi-Z del culling GPU).
+// Al final del frame el color se copia al framebuffer por defecto
+struct RenderTarget {
+    GLuint fbo = 0, color = 0, depth = 0;
+    int width = 0, height = 0;
+
+    // Devuelve true si ha tenido que recrear los attachments
+    bool Resize(int w, int h) {
+        if (w <= 0 || h <= 0 || (w == width && h == height)) return false;
+        width = w;
+        height = h;
+
+        if (fbo == 0) glGenFramebuffers(1, &fbo);
+        if (color == 0) glGenRenderbuffers(1, &color);
+        if (depth != 0) glDeleteTextures(1, &depth);
+        glGenTextures(1, &depth);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, color);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindTexture(GL_TEXTURE_2D, depth);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return true;
+    }
+
+    void Bind() const {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+    }
+
+    void BlitToDefault() const {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void Release() {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (color) glDeleteRenderbuffers(1, &color);
+        if (depth) glDeleteTextures(1, &depth);
+        fbo = color = depth = 0;
+        width = height = 0;
+    }
+};
\ No newline at end of file
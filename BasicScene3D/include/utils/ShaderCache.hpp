@@ -0,0 +1,117 @@
+#pragma once
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+// Cache en disco de binarios de programa (glGetProgramBinary). La clave es un hash de las fuentes de
+// todas las etapas y de la cadena del driver (vendor/renderer/version): otro driver u otra fuente
+// dan otra clave. Si glProgramBinary rechaza el binario (driver actualizado con la misma cadena),
+// Load devuelve 0 y el que llama compila y vuelve a guardar
+struct ShaderCache {
+    std::string directory = "shader_cache";
+
+    static bool Supported() {
+        if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) return false;
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+
+    static const std::string& DriverString() {
+        static const std::string driver = std::string((const char*)glGetString(GL_VENDOR)) + "|" +
+                                          (const char*)glGetString(GL_RENDERER) + "|" +
+                                          (const char*)glGetString(GL_VERSION);
+        return driver;
+    }
+
+    // FNV-1a de 64 bits; se encadena pasando el hash anterior
+    static uint64_t Hash(const void* data, std::size_t size, uint64_t h = 1469598103934665603ull) {
+        const uint8_t* p = (const uint8_t*)data;
+        for (std::size_t i = 0; i < size; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // stages: (tipo de etapa, fuente)
+    static uint64_t Key(const std::vector<std::pair<GLenum, std::string>>& stages) {
+        uint64_t h = Hash(DriverString().data(), DriverString().size());
+        for (const auto& stage : stages) {
+            h = Hash(&stage.first, sizeof(stage.first), h);
+            h = Hash(stage.second.data(), stage.second.size(), h);
+        }
+        return h;
+    }
+
+    // Programa enlazado desde el binario, o 0 si no esta o no vale
+    GLuint Load(uint64_t key) const {
+        std::ifstream file(PathFor(key), std::ios::binary);
+        if (!file) return 0;
+
+        Header h;
+        if (!file.read((char*)&h, sizeof(h)) || std::memcmp(h.magic, "SPB1", 4) != 0 || h.key != key) return 0;
+        std::string driver(h.driverLength, '\0');
+        std::vector<char> binary(h.binaryLength);
+        if (!file.read(driver.data(), driver.size()) || !file.read(binary.data(), binary.size())) return 0;
+        // La clave ya incluye el driver; la cadena guardada protege de colisiones del hash
+        if (driver != DriverString()) return 0;
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, h.format, binary.data(), (GLsizei)binary.size());
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (!ok) {
+            glDeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    // program debe estar enlazado con GL_PROGRAM_BINARY_RETRIEVABLE_HINT. Un fallo al escribir no es
+    // un error: solo se pierde la cache
+    void Store(uint64_t key, GLuint program) const {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &length, &format, binary.data());
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        std::ofstream file(PathFor(key), std::ios::binary | std::ios::trunc);
+        if (!file) return;
+
+        Header h;
+        std::memcpy(h.magic, "SPB1", 4);
+        h.format = format;
+        h.key = key;
+        h.driverLength = (uint32_t)DriverString().size();
+        h.binaryLength = (uint32_t)length;
+        file.write((const char*)&h, sizeof(h));
+        file.write(DriverString().data(), DriverString().size());
+        file.write(binary.data(), length);
+    }
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t format;
+        uint64_t key;
+        uint32_t driverLength;
+        uint32_t binaryLength;
+    };
+
+    std::string PathFor(uint64_t key) const {
+        char name[24];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+        return directory + "/" + name;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,274 @@
+#pragma once
+#include <GL/glew.h>
+#include <array>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <iostream>
+#include "ShaderCache.hpp"
+
+// Bits de variante: cada uno activa un #define en todas las etapas
+enum ShaderFeature : uint32_t {
+    ShaderInstanced = 1u << 0, // INSTANCED: modelo por instancia (location 5); sin el, uniform u_Model
+    ShaderSkinned   = 1u << 1, // SKINNED: paleta SkinPalette en el vertex shader
+    ShaderDualQuat  = 1u << 2, // DUAL_QUAT: paleta de dual quats (solo con SKINNED)
+    ShaderLit       = 1u << 3, // LIT: Lambert con una luz direccional; sin el, color plano
+    ShaderAlphaTest = 1u << 4, // ALPHA_TEST: discard por debajo de u_AlphaCutoff
+    ShaderClustered = 1u << 5, // CLUSTERED: luces puntuales y focos de LightClusters
+};
+constexpr int ShaderFeatureCount = 6;
+
+// Un programa compilandose sin esperar al driver: Begin no consulta ningun estado y, con
+// KHR/ARB_parallel_shader_compile, Done pregunta sin bloquear. Lo usan ShaderVariants y la recarga
+// en caliente de los programas sueltos
+struct AsyncProgram {
+    GLuint program = 0;           // enlazandose; 0 si no hay nada en marcha
+    std::vector<GLuint> shaders;
+
+    static bool ParallelSupported() { return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile; }
+
+    bool Pending() const { return program != 0; }
+
+    // stages: (tipo de etapa, fuente). retrievable: se va a guardar en ShaderCache
+    void Begin(const std::vector<std::pair<GLenum, std::string>>& stages, bool retrievable) {
+        program = glCreateProgram();
+        for (const auto& stage : stages) {
+            const char* src = stage.second.c_str();
+            GLuint shader = glCreateShader(stage.first);
+            glShaderSource(shader, 1, &src, nullptr);
+            glCompileShader(shader);
+            glAttachShader(program, shader);
+            shaders.push_back(shader);
+        }
+        if (retrievable) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+    }
+
+    // Solo con compilacion en paralelo; sin ella no se puede saber sin esperar
+    bool Done() const {
+        GLint done = GL_FALSE;
+        glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &done);
+        return done == GL_TRUE;
+    }
+
+    // Espera si el driver no ha terminado. Devuelve el programa enlazado (pasa a ser de quien llama) o 0;
+    // label identifica el programa en el log de errores
+    GLuint Finish(const std::string& label) {
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            char infoLog[512];
+            for (GLuint shader : shaders) {
+                GLint compiled = GL_FALSE;
+                glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+                if (compiled) continue;
+                glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+                std::cerr << "ERROR::SHADER::COMPILATION_FAILED (" << label << ")\n" << infoLog << std::endl;
+            }
+            glGetProgramInfoLog(program, 512, nullptr, infoLog);
+            std::cerr << "ERROR::PROGRAM::LINKING_FAILED (" << label << ")\n" << infoLog << std::endl;
+            Abort();
+            return 0;
+        }
+
+        for (GLuint shader : shaders) glDeleteShader(shader);
+        shaders.clear();
+        const GLuint linkedProgram = program;
+        program = 0;
+        return linkedProgram;
+    }
+
+    void Abort() {
+        for (GLuint shader : shaders) glDeleteShader(shader);
+        shaders.clear();
+        glDeleteProgram(program);
+        program = 0;
+    }
+};
+
+// Permutaciones de una misma fuente. Cada mascara tiene su hueco en un array: Get es un indice, sin
+// busquedas. Las variantes se compilan al pedirlas (bloquea) o antes con Prewarm, que solo lanza la
+// compilacion; con KHR/ARB_parallel_shader_compile el driver compila en sus hilos y Poll recoge las
+// que han terminado sin esperar. Sin la extension Prewarm solo las encola y Poll lanza una cada vez
+// (muchos drivers compilan dentro de glCompileShader/glLinkProgram). Solo desde el hilo del contexto
+struct ShaderVariants {
+    static constexpr uint32_t Count = 1u << ShaderFeatureCount;
+
+    // sources: (tipo de etapa, fuente con #version en la primera linea). cache puede ser nullptr.
+    // setup: estado que no se enlaza con el programa (bloques de uniforms); retire: programa sustituido
+    // por una recarga, puede seguir en uso en el frame en vuelo
+    void Init(std::vector<std::pair<GLenum, std::string>> stageSources, const ShaderCache* programCache,
+              void (*programSetup)(GLuint), void (*programRetire)(GLuint)) {
+        sources = std::move(stageSources);
+        cache = programCache;
+        setup = programSetup;
+        retire = programRetire;
+
+        parallel = AsyncProgram::ParallelSupported();
+        if (GLEW_KHR_parallel_shader_compile) glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        else if (GLEW_ARB_parallel_shader_compile) glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+    }
+
+    // 0 si la variante no compila
+    GLuint Get(uint32_t features) {
+        Variant& v = variants[features];
+        if (v.program != 0) return v.program;
+        v.queued = false;
+        if (!v.pending.Pending() && !v.failed) Begin(features);
+        if (v.pending.Pending()) Finish(features);
+        return v.program;
+    }
+
+    void Prewarm(const std::vector<uint32_t>& masks) {
+        for (uint32_t features : masks) {
+            Variant& v = variants[features];
+            if (v.program == 0 && !v.pending.Pending() && !v.failed) Queue(features);
+        }
+    }
+
+    // Una vez por frame. Sin compilacion en paralelo no se puede preguntar sin bloquear: se termina
+    // una variante por llamada y, si no queda ninguna a medias, se lanza la siguiente de la cola.
+    // Devuelve las que siguen pendientes o en cola
+    uint32_t Poll() {
+        uint32_t left = 0;
+        bool finished = false;
+        for (uint32_t features = 0; features < Count; ++features) {
+            Variant& v = variants[features];
+            if (!v.pending.Pending()) continue;
+
+            if (parallel ? v.pending.Done() : !finished) {
+                Finish(features);
+                finished = true;
+            }
+            else {
+                ++left;
+            }
+        }
+
+        bool started = left > 0;
+        for (uint32_t features = 0; features < Count; ++features) {
+            Variant& v = variants[features];
+            if (!v.queued) continue;
+            if (started) {
+                ++left;
+                continue;
+            }
+            v.queued = false;
+            Begin(features);
+            started = true;
+            left += v.pending.Pending();
+        }
+        return left;
+    }
+
+    // Fuentes nuevas (recarga en caliente): se recompilan las variantes que ya existian, en segundo plano
+    // como Prewarm. Hasta que la nueva termina se sigue usando la anterior, y si falla se queda la anterior
+    void SetSources(std::vector<std::pair<GLenum, std::string>> stageSources) {
+        sources = std::move(stageSources);
+        for (uint32_t features = 0; features < Count; ++features) {
+            Variant& v = variants[features];
+            v.pending.Abort();
+            v.failed = false;
+            if (v.program != 0 || v.queued) Queue(features);
+        }
+    }
+
+    uint32_t Compiled() const {
+        uint32_t n = 0;
+        for (const Variant& v : variants) n += v.program != 0;
+        return n;
+    }
+
+    void Release() {
+        for (Variant& v : variants) {
+            v.pending.Abort();
+            if (v.program != 0) glDeleteProgram(v.program);
+            v = Variant();
+        }
+    }
+
+    // Inserta los #define detras de #version; #line mantiene los numeros de linea del fichero en los errores
+    static std::string Specialize(const std::string& source, uint32_t features) {
+        static const char* const names[ShaderFeatureCount] = { "INSTANCED", "SKINNED", "DUAL_QUAT", "LIT", "ALPHA_TEST", "CLUSTERED" };
+
+        std::size_t split = 0;
+        if (source.compare(0, 8, "#version") == 0) {
+            split = source.find('\n');
+            split = split == std::string::npos ? source.size() : split + 1;
+        }
+
+        std::string defines;
+        for (int i = 0; i < ShaderFeatureCount; ++i)
+            if (features & (1u << i)) defines += std::string("#define ") + names[i] + " 1\n";
+        defines += "#line " + std::to_string(split > 0 ? 2 : 1) + "\n";
+
+        return source.substr(0, split) + defines + source.substr(split);
+    }
+
+private:
+    struct Variant {
+        GLuint program = 0;   // el que se usa
+        AsyncProgram pending; // primera compilacion o recarga
+        uint64_t key = 0;
+        bool failed = false;  // no se reintenta hasta SetSources
+        bool queued = false;  // esperando turno en Poll (sin compilacion en paralelo)
+    };
+
+    std::array<Variant, Count> variants;
+    std::vector<std::pair<GLenum, std::string>> sources;
+    const ShaderCache* cache = nullptr;
+    void (*setup)(GLuint) = nullptr;
+    void (*retire)(GLuint) = nullptr;
+    bool parallel = false;
+
+    // Con compilacion en paralelo se lanza ya; sin ella espera a Poll
+    void Queue(uint32_t features) {
+        if (parallel) Begin(features);
+        else variants[features].queued = true;
+    }
+
+    // Lanza compilacion y enlace sin consultar ningun estado (consultarlo esperaria al driver)
+    void Begin(uint32_t features) {
+        Variant& v = variants[features];
+        if (sources.empty()) {
+            v.failed = true;
+            return;
+        }
+        std::vector<std::pair<GLenum, std::string>> stages;
+        for (const auto& stage : sources)
+            stages.push_back({ stage.first, Specialize(stage.second, features) });
+
+        if (cache) {
+            v.key = ShaderCache::Key(stages);
+            GLuint cached = cache->Load(v.key);
+            if (cached != 0) {
+                Install(v, cached);
+                return;
+            }
+        }
+
+        v.pending.Begin(stages, cache != nullptr);
+    }
+
+    // Espera si el driver no ha terminado
+    void Finish(uint32_t features) {
+        Variant& v = variants[features];
+        const GLuint program = v.pending.Finish("variant " + std::to_string(features));
+        if (program == 0) {
+            v.failed = v.program == 0;
+            return;
+        }
+        if (cache) cache->Store(v.key, program);
+        Install(v, program);
+    }
+
+    void Install(Variant& v, GLuint program) {
+        if (setup) setup(program);
+        if (v.program != 0) {
+            if (retire) retire(v.program);
+            else glDeleteProgram(v.program);
+        }
+        v.program = program;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <cstddef>
+#include "Skeleton.hpp"
+
+// Donde se hace el skinning: CPU (SIMD + VBO dinamico) o GPU (paleta en UBO + vertex shader)
+enum class SkinningPath { CPU, GPU };
+
+// Binding point del bloque SkinPalette de vs.glsl (las variantes SKINNED y DUAL_QUAT comparten UBO)
+#define SKIN_PALETTE_BINDING 0
+
+inline SkinningPath ChooseSkinningPath() {
+    // La paleta de 256 joints ocupa 12KB; el minimo garantizado de un UBO es 16KB
+    if (!GLEW_VERSION_3_1 && !GLEW_ARB_uniform_buffer_object) return SkinningPath::CPU;
+
+    GLint maxBlockSize = 0;
+    glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &maxBlockSize);
+    if (maxBlockSize < (GLint)(Skeleton::MaxJoints * 12 * sizeof(float))) return SkinningPath::CPU;
+
+    return SkinningPath::GPU;
+}
+
+struct SkinnedMesh {
+    // vaoGpu lee el vertice completo; vaoCpu lee posicion + normal ya deformadas
+    GLuint vaoGpu = 0, vaoCpu = 0;
+    GLuint vboBind = 0, vboSkinned = 0, ebo = 0, uboPalette = 0;
+    int indexCount = 0;
+
+    std::vector<SkinVertex> vertices;
+    std::vector<float> skinned; // 6 floats per vertex
+
+    void Init(const std::vector<SkinVertex>& verts, const std::vector<unsigned int>& indices) {
+        vertices = verts;
+        skinned.assign(vertices.size() * 6, 0.0f);
+        indexCount = (int)indices.size();
+
+        if (vaoGpu == 0) glGenVertexArrays(1, &vaoGpu);
+        if (vaoCpu == 0) glGenVertexArrays(1, &vaoCpu);
+        if (vboBind == 0) glGenBuffers(1, &vboBind);
+        if (vboSkinned == 0) glGenBuffers(1, &vboSkinned);
+        if (ebo == 0) glGenBuffers(1, &ebo);
+        if (uboPalette == 0) glGenBuffers(1, &uboPalette);
+
+        // GPU: atributos completos, el shader hace el skinning
+        glBindVertexArray(vaoGpu);
+        glBindBuffer(GL_ARRAY_BUFFER, vboBind);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(SkinVertex), vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, position));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, normal));
+        glEnableVertexAttribArray(1);
+        glVertexAttribIPointer(3, 4, GL_UNSIGNED_BYTE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, joints));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, weights));
+        glEnableVertexAttribArray(4);
+
+        // CPU: posicion + normal deformadas, se reescriben cada frame
+        glBindVertexArray(vaoCpu);
+        glBindBuffer(GL_ARRAY_BUFFER, vboSkinned);
+        glBufferData(GL_ARRAY_BUFFER, skinned.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        glBindVertexArray(0);
+
+        glBindBuffer(GL_UNIFORM_BUFFER, uboPalette);
+        glBufferData(GL_UNIFORM_BUFFER, Skeleton::MaxJoints * 12 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    // Deforma en CPU sin tocar GL (se puede llamar desde otro hilo); out: 6 floats por vertice
+    void SkinCPU(const std::vector<float>& palette, SkinningBlend blend, std::vector<float>& out) const {
+        out.resize(vertices.size() * 6);
+        if (blend == SkinningBlend::DualQuat)
+            Skinning::SkinVerticesDualQuat(vertices.data(), vertices.size(), palette.data(), out.data());
+        else
+            Skinning::SkinVertices(vertices.data(), vertices.size(), palette.data(), out.data());
+    }
+
+    void UploadSkinned(const std::vector<float>& data) {
+        glBindBuffer(GL_ARRAY_BUFFER, vboSkinned);
+        // Orphaning: evita esperar a que la GPU acabe con el frame anterior
+        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, data.size() * sizeof(float), data.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void UpdateCPU(const std::vector<float>& palette, SkinningBlend blend = SkinningBlend::Linear) {
+        SkinCPU(palette, blend, skinned);
+        UploadSkinned(skinned);
+    }
+
+    // Solo sube la paleta a uboPalette; el draw la enlaza en SKIN_PALETTE_BINDING (Bind o BindUniformBuffer)
+    void UploadPaletteGPU(const std::vector<float>& palette) {
+        glBindBuffer(GL_UNIFORM_BUFFER, uboPalette);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, palette.size() * sizeof(float), palette.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    GLuint Vao(SkinningPath path) const { return path == SkinningPath::GPU ? vaoGpu : vaoCpu; }
+
+    void Bind(SkinningPath path) const {
+        glBindVertexArray(Vao(path));
+        if (path == SkinningPath::GPU) glBindBufferBase(GL_UNIFORM_BUFFER, SKIN_PALETTE_BINDING, uboPalette);
+    }
+
+    void DrawBound() const {
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    }
+
+    void Draw(SkinningPath path) {
+        Bind(path);
+        DrawBound();
+        glBindVertexArray(0);
+    }
+
+    // Caja alargada en Y partida en 'segments' tramos; el tramo i pesa sobre el joint i
+    void InitBoxChain(int segments, float segmentLength) {
+        std::vector<SkinVertex> verts;
+        std::vector<unsigned int> indices;
+
+        const float h = 0.25f;
+        const float faceN[4][3] = { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 0, -1 }, { -1, 0, 0 } };
+        const float faceA[4][2] = { { -h, h }, { h, h }, { h, -h }, { -h, -h } };
+        const float faceB[4][2] = { { h, h }, { h, -h }, { -h, -h }, { -h, h } };
+
+        for (int f = 0; f < 4; ++f) {
+            unsigned int base = (unsigned int)verts.size();
+            for (int s = 0; s <= segments; ++s) {
+                // Cada anillo pesa sobre su joint y el anterior para suavizar el pliegue
+                int j = s < segments ? s : segments - 1;
+                int jPrev = s > 0 ? s - 1 : 0;
+                for (int k = 0; k < 2; ++k) {
+                    SkinVertex v;
+                    v.position[0] = k == 0 ? faceA[f][0] : faceB[f][0];
+                    v.position[1] = s * segmentLength;
+                    v.position[2] = k == 0 ? faceA[f][1] : faceB[f][1];
+                    v.normal[0] = faceN[f][0]; v.normal[1] = faceN[f][1]; v.normal[2] = faceN[f][2];
+                    v.joints[0] = (uint8_t)j; v.joints[1] = (uint8_t)jPrev;
+                    v.weights[0] = (s == 0 || s == segments) ? 1.0f : 0.5f;
+                    v.weights[1] = 1.0f - v.weights[0];
+                    verts.push_back(v);
+                }
+            }
+            for (int s = 0; s < segments; ++s) {
+                unsigned int a = base + s * 2;
+                indices.insert(indices.end(), { a, a + 1, a + 3, a + 3, a + 2, a });
+            }
+        }
+
+        Init(verts, indices);
+    }
+};
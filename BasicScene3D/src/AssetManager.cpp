@@ -0,0 +1,705 @@
+#include "AssetManager.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    const char* TypeTag(AssetType type)
+    {
+        switch (type)
+        {
+        case AssetType::Mesh: return "mesh:";
+        case AssetType::Texture: return "texture:";
+        default: return "scene:";
+        }
+    }
+
+    bool ReadFile(const std::string& path, std::string& out)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        const std::streamoff size = file.tellg();
+        if (size < 0) return false;
+        out.resize(static_cast<std::size_t>(size));
+        file.seekg(0);
+        return static_cast<bool>(file.read(out.data(), size));
+    }
+
+    // Nodos sin AssetManager (ParseScene sin mallas)
+    void DeleteTree(GameObject* node)
+    {
+        for (GameObject* child : node->children)
+            DeleteTree(child);
+        delete node;
+    }
+
+    const char* SkipSpaces(const char* p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        return p;
+    }
+
+    const char* NextLine(const char* p, const char* end)
+    {
+        while (p < end && *p != '\n') ++p;
+        return p < end ? p + 1 : end;
+    }
+
+    // Esquina de una cara de OBJ: indices de posicion, coordenada de textura y normal (-1 si falta)
+    struct ObjCorner
+    {
+        int v, t, n;
+        bool operator==(const ObjCorner& o) const { return v == o.v && t == o.t && n == o.n; }
+    };
+
+    struct ObjCornerHash
+    {
+        std::size_t operator()(const ObjCorner& c) const
+        {
+            return static_cast<std::size_t>(c.v) * 73856093u ^ static_cast<std::size_t>(c.t) * 19349663u ^ static_cast<std::size_t>(c.n) * 83492791u;
+        }
+    };
+
+    // Indice de OBJ (desde 1, negativo = relativo al final) a indice desde 0; -1 si falta o no vale
+    int ObjIndex(const char*& p, const char* end, std::size_t count)
+    {
+        if (p >= end || *p == '/' || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') return -1;
+        char* next = nullptr;
+        const long i = std::strtol(p, &next, 10);
+        p = next;
+        if (i > 0 && static_cast<std::size_t>(i) <= count) return static_cast<int>(i - 1);
+        if (i < 0 && static_cast<std::size_t>(-i) <= count) return static_cast<int>(count + i);
+        return -1;
+    }
+
+    bool ReadPpmInt(const std::string& bytes, std::size_t& pos, int& value)
+    {
+        // Espacios y comentarios de la cabecera
+        while (pos < bytes.size())
+        {
+            if (bytes[pos] == '#')
+                while (pos < bytes.size() && bytes[pos] != '\n') ++pos;
+            else if (std::isspace(static_cast<unsigned char>(bytes[pos])))
+                ++pos;
+            else
+                break;
+        }
+        if (pos >= bytes.size() || !std::isdigit(static_cast<unsigned char>(bytes[pos]))) return false;
+        value = 0;
+        while (pos < bytes.size() && std::isdigit(static_cast<unsigned char>(bytes[pos])))
+        {
+            value = value * 10 + (bytes[pos] - '0');
+            if (value > (1 << 16)) return false;
+            ++pos;
+        }
+        return true;
+    }
+}
+
+AssetManager::AssetManager(unsigned decodeThreads)
+{
+    entries.push_back({ AssetType::Mesh, std::string(), AssetState::Failed, std::string() });
+    reader = std::thread(&AssetManager::ReadLoop, this);
+    for (unsigned i = 0; i < std::max(1u, decodeThreads); ++i)
+        decoders.emplace_back(&AssetManager::DecodeLoop, this);
+}
+
+AssetManager::~AssetManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    readWake.notify_all();
+    decodeWake.notify_all();
+    reader.join();
+    for (std::thread& t : decoders) t.join();
+
+    for (LoadedAsset& asset : decoded)
+        for (GameObject* root : asset.roots)
+            DestroyTree(root);
+}
+
+AssetHandle AssetManager::LoadMesh(const std::string& path) { return Request(AssetType::Mesh, path); }
+AssetHandle AssetManager::LoadTexture(const std::string& path) { return Request(AssetType::Texture, path); }
+AssetHandle AssetManager::LoadScene(const std::string& path) { return Request(AssetType::Scene, path); }
+
+AssetHandle AssetManager::Request(AssetType type, const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    // Mallas y texturas se comparten; la entrada de una escena solo se reutiliza si ya se solto
+    const std::string key = TypeTag(type) + path;
+    const auto it = byPath.find(key);
+    if (it != byPath.end())
+    {
+        Entry& e = entries[it->second];
+        if (e.state == AssetState::Unloaded)
+        {
+            e.refs = 1;
+            e.state = AssetState::Pending;
+            e.error.clear();
+            Queue(it->second);
+            return { it->second };
+        }
+        if (type != AssetType::Scene)
+        {
+            ++e.refs;
+            return { it->second };
+        }
+    }
+
+    const uint32_t id = static_cast<uint32_t>(entries.size());
+    entries.push_back({ type, path, AssetState::Pending, std::string() });
+    byPath[key] = id;
+    Queue(id);
+    return { id };
+}
+
+void AssetManager::Queue(uint32_t id)
+{
+    const Entry& e = entries[id];
+    toRead.push_back({ id, e.generation, e.type, e.path, std::string() });
+    ++pending;
+    readWake.notify_one();
+}
+
+void AssetManager::Release(AssetHandle handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ReleaseLocked(handle.id);
+}
+
+void AssetManager::SetGpuTextureFormats(uint32_t formats)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    gpuTextureFormats = formats | TextureCodec::Bit(TextureFormat::RGBA8);
+}
+
+void AssetManager::ReleaseLocked(uint32_t id)
+{
+    if (id == 0 || id >= entries.size()) return;
+    Entry& e = entries[id];
+    if (e.state == AssetState::Unloaded || --e.refs > 0) return;
+
+    // Lo que este en camino con la generacion vieja se descarta al llegar
+    ++e.generation;
+    if (e.state == AssetState::Pending) --pending;
+    else if (e.state == AssetState::Ready && e.type != AssetType::Scene) evicted.push_back({ id });
+    e.state = AssetState::Unloaded;
+}
+
+void AssetManager::DestroyTree(GameObject* root)
+{
+    std::vector<GameObject*> stack = { root };
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!stack.empty())
+    {
+        GameObject* node = stack.back();
+        stack.pop_back();
+        stack.insert(stack.end(), node->children.begin(), node->children.end());
+        ReleaseLocked(node->mesh);
+        ReleaseLocked(node->texture);
+        delete node;
+    }
+}
+
+std::vector<AssetHandle> AssetManager::TakeEvicted()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<AssetHandle> result;
+    result.swap(evicted);
+    return result;
+}
+
+AssetState AssetManager::State(AssetHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return handle.id < entries.size() ? entries[handle.id].state : AssetState::Failed;
+}
+
+std::string AssetManager::Error(AssetHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return handle.id < entries.size() ? entries[handle.id].error : std::string("invalid handle");
+}
+
+std::string AssetManager::Path(AssetHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return handle.id < entries.size() ? entries[handle.id].path : std::string();
+}
+
+std::size_t AssetManager::PendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending;
+}
+
+bool AssetManager::PopDecoded(LoadedAsset& out)
+{
+    std::vector<GameObject*> stale;
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!found && !decoded.empty())
+        {
+            LoadedAsset& front = decoded.front();
+            if (front.generation == entries[front.handle.id].generation)
+            {
+                out = std::move(front);
+                found = true;
+            }
+            else
+            {
+                stale.insert(stale.end(), front.roots.begin(), front.roots.end());
+            }
+            decoded.pop_front();
+        }
+    }
+    for (GameObject* root : stale) DestroyTree(root);
+    return found;
+}
+
+bool AssetManager::MarkReady(const LoadedAsset& asset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& e = entries[asset.handle.id];
+    if (e.generation != asset.generation || e.state != AssetState::Pending) return false;
+    e.state = AssetState::Ready;
+    --pending;
+    return true;
+}
+
+void AssetManager::MarkFailed(const LoadedAsset& asset, const std::string& error)
+{
+    Fail(asset.handle.id, asset.generation, error);
+}
+
+void AssetManager::Fail(uint32_t id, uint32_t generation, const std::string& error)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& e = entries[id];
+    if (e.generation != generation || e.state != AssetState::Pending) return;
+    e.state = AssetState::Failed;
+    e.error = error;
+    --pending;
+}
+
+void AssetManager::ReadLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        readWake.wait(lock, [this] { return stopping || (!toRead.empty() && toDecode.size() < MaxReadAhead); });
+        if (stopping) return;
+
+        Job job = std::move(toRead.front());
+        toRead.pop_front();
+        if (job.generation != entries[job.id].generation) continue;
+
+        // Sin el lock durante la lectura: las peticiones nuevas no esperan al disco
+        lock.unlock();
+        const bool ok = ReadFile(job.path, job.bytes);
+        if (!ok) Fail(job.id, job.generation, "cannot read " + job.path);
+        lock.lock();
+
+        if (ok)
+        {
+            toDecode.push_back(std::move(job));
+            decodeWake.notify_one();
+        }
+    }
+}
+
+void AssetManager::DecodeLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        decodeWake.wait(lock, [this] { return stopping || !toDecode.empty(); });
+        if (stopping) return;
+
+        Job job = std::move(toDecode.front());
+        toDecode.pop_front();
+        readWake.notify_one();
+        if (job.generation != entries[job.id].generation) continue;
+        const uint32_t textureFormats = gpuTextureFormats;
+        lock.unlock();
+
+        LoadedAsset asset;
+        asset.handle = { job.id };
+        asset.generation = job.generation;
+        asset.type = job.type;
+        std::string error;
+        bool ok = false;
+        switch (job.type)
+        {
+        case AssetType::Mesh: ok = ParseObj(job.bytes, asset.mesh, error); break;
+        case AssetType::Texture: ok = ParseTexture(job.bytes, textureFormats, asset.image, error); break;
+        case AssetType::Scene:
+            ok = ParseScene(job.bytes, std::filesystem::path(job.path).parent_path().string(), this, asset.roots, error);
+            break;
+        }
+        if (!ok) Fail(job.id, job.generation, job.path + ": " + error);
+
+        lock.lock();
+        if (ok && job.generation == entries[job.id].generation)
+        {
+            decoded.push_back(std::move(asset));
+        }
+        else if (!asset.roots.empty())
+        {
+            // Soltada mientras se decodificaba
+            lock.unlock();
+            for (GameObject* root : asset.roots) DestroyTree(root);
+            lock.lock();
+        }
+    }
+}
+
+bool AssetManager::ParseObj(const std::string& text, MeshData& out, std::string& error)
+{
+    std::vector<float> v, vt, vn;
+    // Un vertice por esquina (posicion, coordenada de textura, normal) distinta
+    std::unordered_map<ObjCorner, unsigned int, ObjCornerHash> remap;
+    std::vector<int> vertexPosition; // posicion de cada vertice de salida (para normales que faltan)
+    bool missingNormals = false;
+
+    out = MeshData();
+    const char* p = text.data();
+    const char* end = p + text.size();
+    int line = 0;
+    std::vector<unsigned int> face;
+    while (p < end)
+    {
+        ++line;
+        const char* lineEnd = p;
+        while (lineEnd < end && *lineEnd != '\n') ++lineEnd;
+        p = SkipSpaces(p, lineEnd);
+
+        if (lineEnd - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+        {
+            const char* q = p + 1;
+            for (int k = 0; k < 3; ++k)
+            {
+                char* next = nullptr;
+                v.push_back(std::strtof(q, &next));
+                q = next;
+            }
+        }
+        else if (lineEnd - p > 3 && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t'))
+        {
+            const char* q = p + 2;
+            for (int k = 0; k < 2; ++k)
+            {
+                char* next = nullptr;
+                vt.push_back(std::strtof(q, &next));
+                q = next;
+            }
+        }
+        else if (lineEnd - p > 3 && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t'))
+        {
+            const char* q = p + 2;
+            for (int k = 0; k < 3; ++k)
+            {
+                char* next = nullptr;
+                vn.push_back(std::strtof(q, &next));
+                q = next;
+            }
+        }
+        else if (lineEnd - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+        {
+            face.clear();
+            p = SkipSpaces(p + 1, lineEnd);
+            while (p < lineEnd && *p != '\r')
+            {
+                // v, v/vt, v//vn o v/vt/vn
+                const int vi = ObjIndex(p, lineEnd, v.size() / 3);
+                int ti = -1, ni = -1;
+                if (p < lineEnd && *p == '/')
+                {
+                    ++p;
+                    ti = ObjIndex(p, lineEnd, vt.size() / 2);
+                    if (p < lineEnd && *p == '/')
+                    {
+                        ++p;
+                        ni = ObjIndex(p, lineEnd, vn.size() / 3);
+                    }
+                }
+                if (vi < 0)
+                {
+                    error = "bad face index at line " + std::to_string(line);
+                    return false;
+                }
+                while (p < lineEnd && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+                p = SkipSpaces(p, lineEnd);
+
+                const ObjCorner key{ vi, ti, ni };
+                auto it = remap.find(key);
+                if (it == remap.end())
+                {
+                    const unsigned int index = static_cast<unsigned int>(vertexPosition.size());
+                    it = remap.emplace(key, index).first;
+                    vertexPosition.push_back(vi);
+                    out.positions.insert(out.positions.end(), { v[vi * 3], v[vi * 3 + 1], v[vi * 3 + 2] });
+                    // En OBJ v = 0 es la fila de abajo de la imagen
+                    if (ti >= 0)
+                        out.uvs.insert(out.uvs.end(), { vt[ti * 2], 1.0f - vt[ti * 2 + 1] });
+                    else
+                        out.uvs.insert(out.uvs.end(), { 0.0f, 0.0f });
+                    if (ni >= 0)
+                        out.normals.insert(out.normals.end(), { vn[ni * 3], vn[ni * 3 + 1], vn[ni * 3 + 2] });
+                    else
+                    {
+                        out.normals.insert(out.normals.end(), { 0.0f, 0.0f, 0.0f });
+                        missingNormals = true;
+                    }
+                }
+                face.push_back(it->second);
+            }
+            if (face.size() < 3)
+            {
+                error = "face with less than 3 vertices at line " + std::to_string(line);
+                return false;
+            }
+            // Abanico: los poligonos convexos se parten en triangulos desde el primer vertice
+            for (std::size_t i = 1; i + 1 < face.size(); ++i)
+                out.indices.insert(out.indices.end(), { face[0], face[i], face[i + 1] });
+        }
+        p = NextLine(lineEnd, end);
+    }
+
+    if (out.indices.empty())
+    {
+        error = "no faces";
+        return false;
+    }
+
+    if (missingNormals)
+    {
+        // Suavizadas: suma de las normales de cara (ponderadas por area) de cada posicion
+        std::vector<float> accum(v.size(), 0.0f);
+        for (std::size_t t = 0; t < out.indices.size(); t += 3)
+        {
+            const float* a = &out.positions[out.indices[t] * 3];
+            const float* b = &out.positions[out.indices[t + 1] * 3];
+            const float* c = &out.positions[out.indices[t + 2] * 3];
+            const float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            const float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+            const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            for (int k = 0; k < 3; ++k)
+            {
+                float* dst = &accum[vertexPosition[out.indices[t + k]] * 3];
+                dst[0] += n[0]; dst[1] += n[1]; dst[2] += n[2];
+            }
+        }
+        for (std::size_t i = 0; i < vertexPosition.size(); ++i)
+        {
+            float* n = &out.normals[i * 3];
+            if (n[0] != 0.0f || n[1] != 0.0f || n[2] != 0.0f) continue;
+            const float* s = &accum[vertexPosition[i] * 3];
+            const float len = std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+            if (len > 0.0f) { n[0] = s[0] / len; n[1] = s[1] / len; n[2] = s[2] / len; }
+        }
+    }
+
+    double hx = 0, hy = 0, hz = 0;
+    for (std::size_t i = 0; i < out.positions.size(); i += 3)
+    {
+        hx = std::max(hx, (double)std::fabs(out.positions[i]));
+        hy = std::max(hy, (double)std::fabs(out.positions[i + 1]));
+        hz = std::max(hz, (double)std::fabs(out.positions[i + 2]));
+    }
+    out.halfExtents = { hx, hy, hz };
+    return true;
+}
+
+bool AssetManager::ParsePpm(const std::string& bytes, ImageData& out, std::string& error)
+{
+    // Solo P6 de 8 bits (el formato que escribe FrameWriter)
+    if (bytes.size() < 2 || bytes[0] != 'P' || bytes[1] != '6')
+    {
+        error = "not a binary PPM (P6)";
+        return false;
+    }
+    std::size_t pos = 2;
+    int width = 0, height = 0, maxValue = 0;
+    if (!ReadPpmInt(bytes, pos, width) || !ReadPpmInt(bytes, pos, height) || !ReadPpmInt(bytes, pos, maxValue) ||
+        width <= 0 || height <= 0 || maxValue != 255)
+    {
+        error = "bad PPM header";
+        return false;
+    }
+    ++pos; // un solo espacio antes de los pixeles
+    const std::size_t count = static_cast<std::size_t>(width) * height;
+    if (bytes.size() < pos + count * 3)
+    {
+        error = "truncated PPM";
+        return false;
+    }
+
+    out = ImageData();
+    out.width = width;
+    out.height = height;
+    out.levels.assign(1, std::vector<uint8_t>(count * 4));
+    uint8_t* dst = out.levels[0].data();
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(bytes.data() + pos);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 255;
+    }
+    return true;
+}
+
+bool AssetManager::ParseTexture(const std::string& bytes, uint32_t gpuFormats, ImageData& out, std::string& error)
+{
+    if (!bytes.empty() && static_cast<uint8_t>(bytes[0]) == 0xAB)
+    {
+        if (!TextureCodec::ParseKtx2(bytes, out, error)) return false;
+    }
+    else
+    {
+        if (!ParsePpm(bytes, out, error)) return false;
+        TextureCodec::BuildMipChain(out);
+    }
+    // Aqui y no en el hilo de GL: la descompresion es lo mas caro de la carga
+    if (!(gpuFormats & TextureCodec::Bit(out.format)))
+        TextureCodec::DecodeToRgba8(out);
+    return true;
+}
+
+bool AssetManager::ParseScene(const std::string& text, const std::string& baseDir, AssetManager* meshes,
+                              std::vector<GameObject*>& roots, std::string& error)
+{
+    std::vector<GameObject*> nodes;
+    roots.clear();
+    auto fail = [&](int line, const std::string& what) {
+        for (GameObject* root : roots)
+        {
+            if (meshes) meshes->DestroyTree(root);
+            else DeleteTree(root);
+        }
+        roots.clear();
+        error = what + " at line " + std::to_string(line);
+        return false;
+    };
+
+    std::istringstream in(text);
+    std::string lineText;
+    int line = 0;
+    while (std::getline(in, lineText))
+    {
+        ++line;
+        std::istringstream ls(lineText);
+        std::string keyword;
+        if (!(ls >> keyword) || keyword[0] == '#') continue;
+
+        if (keyword == "node")
+        {
+            int parent = -1;
+            Vec3 p, r, s;
+            std::string mesh, name;
+            if (!(ls >> parent >> p.x >> p.y >> p.z >> r.x >> r.y >> r.z >> s.x >> s.y >> s.z >> mesh))
+                return fail(line, "malformed node");
+            if (parent >= static_cast<int>(nodes.size()))
+                return fail(line, "parent after child");
+            std::getline(ls >> std::ws, name);
+            if (!name.empty() && name.back() == '\r') name.pop_back();
+
+            GameObject* node = new GameObject(name.empty() ? "Node" + std::to_string(nodes.size()) : name);
+            node->transform.position = p;
+            node->transform.SetEulerRotation(r);
+            node->transform.scale = s;
+            if (mesh != "-" && meshes)
+                node->mesh = meshes->LoadMesh((std::filesystem::path(baseDir) / mesh).lexically_normal().string()).id;
+
+            if (parent >= 0) nodes[parent]->AddChild(node);
+            else roots.push_back(node);
+            nodes.push_back(node);
+        }
+        else if (keyword == "light")
+        {
+            if (nodes.empty()) return fail(line, "light without node");
+            std::string type;
+            Light& light = nodes.back()->light;
+            if (!(ls >> type >> light.color.x >> light.color.y >> light.color.z >> light.intensity >> light.range))
+                return fail(line, "malformed light");
+            double inner = 0.0, outer = 0.0;
+            if (ls >> inner >> outer)
+            {
+                light.innerAngle = inner;
+                light.outerAngle = outer;
+            }
+            if (type == "point") light.type = LightType::Point;
+            else if (type == "spot") light.type = LightType::Spot;
+            else return fail(line, "unknown light type '" + type + "'");
+        }
+        else if (keyword == "occluder")
+        {
+            if (nodes.empty()) return fail(line, "occluder without node");
+            nodes.back()->occluder = true;
+        }
+        else if (keyword == "texture")
+        {
+            std::string path;
+            if (nodes.empty()) return fail(line, "texture without node");
+            if (!(ls >> path)) return fail(line, "malformed texture");
+            if (meshes && nodes.back()->texture == 0)
+                nodes.back()->texture = meshes->LoadTexture((std::filesystem::path(baseDir) / path).lexically_normal().string()).id;
+        }
+        else
+        {
+            return fail(line, "unknown keyword '" + keyword + "'");
+        }
+    }
+    return true;
+}
+
+std::string AssetManager::SerializeScene(const std::vector<GameObject*>& roots, const std::function<std::string(uint32_t)>& assetPath)
+{
+    // 12 cifras: milimetros a cientos de km del origen sin los restos de la conversion a decimal
+    std::ostringstream out;
+    out << std::setprecision(12);
+
+    // Preorden: el indice del padre siempre es menor que el del hijo
+    std::vector<std::pair<const GameObject*, int>> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+        stack.push_back({ *it, -1 });
+    int count = 0;
+    while (!stack.empty())
+    {
+        const GameObject* node = stack.back().first;
+        const int parent = stack.back().second;
+        stack.pop_back();
+        const int index = count++;
+
+        const Transform& t = node->transform;
+        const std::string mesh = node->mesh != 0 ? assetPath(node->mesh) : std::string();
+        out << "node " << parent << ' '
+            << t.position.x << ' ' << t.position.y << ' ' << t.position.z << ' '
+            << t.eulerRotation.x << ' ' << t.eulerRotation.y << ' ' << t.eulerRotation.z << ' '
+            << t.scale.x << ' ' << t.scale.y << ' ' << t.scale.z << ' '
+            << (mesh.empty() ? "-" : mesh) << ' ' << node->name << '\n';
+
+        const Light& light = node->light;
+        if (light.type != LightType::None)
+            out << "light " << (light.type == LightType::Spot ? "spot " : "point ")
+                << light.color.x << ' ' << light.color.y << ' ' << light.color.z << ' '
+                << light.intensity << ' ' << light.range << ' ' << light.innerAngle << ' ' << light.outerAngle << '\n';
+        if (node->occluder) out << "occluder\n";
+        if (node->texture != 0) out << "texture " << assetPath(node->texture) << '\n';
+
+        for (auto it = node->children.rbegin(); it != node->children.rend(); ++it)
+            stack.push_back({ *it, index });
+    }
+    return out.str();
+}
\ No newline at end of file
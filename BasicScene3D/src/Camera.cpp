@@ -5,7 +5,14 @@ Matrix4x4 Camera::GetViewMatrix() const
 {
     // La View Matrix es la inversa de la transform de la cmara
     // (no debe tener escala)
-    return transform.GetLocalMatrix().InverseTR();
+    return transform.GetLocalMatrix().InverseRigid().ToMatrix4x4();
+}
+
+Matrix4x4 Camera::GetRenderViewMatrix() const
+{
+    Transform rotation = transform;
+    rotation.position = { 0.0, 0.0, 0.0 };
+    return rotation.GetLocalMatrix().InverseRigid().ToMatrix4x4();
 }
 
 Matrix4x4 Camera::GetProjectionMatrix() const
@@ -19,4 +26,23 @@ Matrix4x4 Camera::GetProjectionMatrix() const
     const double top = halfHeight;
 
     return Matrix4x4::Perspective(left, right, bottom, top, nearPlane, farPlane);
+}
+
+Ray Camera::ScreenPointToRay(double x, double y, double width, double height) const
+{
+    const double ndcX = 2.0 * x / width - 1.0;
+    const double ndcY = 1.0 - 2.0 * y / height;
+
+    Matrix4x4 invViewProj = GetProjectionMatrix().Multiply(GetViewMatrix()).Inverse();
+
+    Vec4 nearH = invViewProj.Multiply(Vec4(ndcX, ndcY, -1.0, 1.0));
+    Vec4 farH = invViewProj.Multiply(Vec4(ndcX, ndcY, 1.0, 1.0));
+
+    Vec3 nearP{ nearH.x / nearH.w, nearH.y / nearH.w, nearH.z / nearH.w };
+    Vec3 farP{ farH.x / farH.w, farH.y / farH.w, farH.z / farH.w };
+
+    Ray ray;
+    ray.origin = nearP;
+    ray.direction = Vec3{ farP.x - nearP.x, farP.y - nearP.y, farP.z - nearP.z }.Normalize();
+    return ray;
 }
\ No newline at end of file
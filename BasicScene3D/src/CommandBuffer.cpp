@@ -0,0 +1,41 @@
+#include "CommandBuffer.hpp"
+
+void CommandBuffer::SetMatrix(UniformSlot slot, const Matrix4x4& m)
+{
+    CmdSetMatrix cmd;
+    cmd.slot = slot;
+    for (int i = 0; i < 16; ++i) cmd.m[i] = static_cast<float>(m.m[i]);
+    Push(CommandType::SetMatrix, cmd);
+}
+
+void CommandBuffer::SetColor(const Vec3& color)
+{
+    Push(CommandType::SetColor, CmdSetColor{ { static_cast<float>(color.x), static_cast<float>(color.y), static_cast<float>(color.z) } });
+}
+
+Affine3f* CommandBuffer::UploadInstances(uint32_t buffer, uint32_t count)
+{
+    const CmdUploadInstances cmd{ buffer, count };
+    return reinterpret_cast<Affine3f*>(PushRecord(CommandType::UploadInstances, &cmd, sizeof(cmd), count * sizeof(Affine3f)));
+}
+
+Affine3f* CommandBuffer::IndirectDraw(uint32_t mesh, uint32_t count)
+{
+    const CmdIndirectDraw cmd{ mesh, count };
+    return reinterpret_cast<Affine3f*>(PushRecord(CommandType::IndirectDraw, &cmd, sizeof(cmd), count * sizeof(Affine3f)));
+}
+
+uint8_t* CommandBuffer::PushRecord(CommandType type, const void* cmd, std::size_t cmdBytes, std::size_t extraBytes)
+{
+    Header h{};
+    h.type = type;
+    h.size = static_cast<uint32_t>(sizeof(Header) + cmdBytes + extraBytes);
+
+    // Clear conserva la capacidad: tras los primeros frames grabar no reserva memoria
+    const std::size_t offset = bytes.size();
+    bytes.resize(offset + h.size);
+    uint8_t* dst = bytes.data() + offset;
+    std::memcpy(dst, &h, sizeof(Header));
+    if (cmdBytes) std::memcpy(dst + sizeof(Header), cmd, cmdBytes);
+    return dst + sizeof(Header) + cmdBytes;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "CommandJournal.hpp"
+#include <stdexcept>
+
+CommandJournal::CommandJournal(std::size_t editCapacity, std::size_t groupCapacity)
+    : edits(editCapacity), groups(groupCapacity)
+{
+    if (editCapacity == 0 || groupCapacity == 0)
+        throw std::invalid_argument("CommandJournal: capacity must be > 0");
+}
+
+Vec3 CommandJournal::Read(const GameObject* object, TransformField field)
+{
+    switch (field)
+    {
+    case TransformField::Position: return object->transform.position;
+    case TransformField::Rotation: return object->transform.eulerRotation;
+    case TransformField::Scale:    return object->transform.scale;
+    }
+    return {};
+}
+
+void CommandJournal::Write(GameObject* object, TransformField field, const Vec3& value)
+{
+    switch (field)
+    {
+    case TransformField::Position: object->transform.position = value; break;
+    case TransformField::Rotation: object->transform.SetEulerRotation(value); break;
+    case TransformField::Scale:    object->transform.scale = value; break;
+    }
+    object->MarkWorldDirty();
+}
+
+void CommandJournal::Clear()
+{
+    editTail = editHead = 0;
+    groupTail = groupCursor = groupHead = 0;
+    groupOpen = false;
+    overflowed = false;
+}
+
+void CommandJournal::Forget(const std::unordered_set<const GameObject*>& objects)
+{
+    if (objects.empty()) return;
+    for (uint64_t i = editTail; i < editHead; ++i)
+    {
+        Edit& e = EditAt(i);
+        if (objects.count(e.object)) e.object = nullptr;
+    }
+    // Un arrastre abierto sobre un objeto borrado no debe fusionarse con uno nuevo
+    groupOpen = false;
+}
+
+void CommandJournal::EvictOldestGroup()
+{
+    const Group& g = GroupAt(groupTail);
+    editTail = g.first + g.count;
+    groupTail++;
+}
+
+void CommandJournal::BeginTick(TransformField field)
+{
+    tickIndex = 0;
+
+    // El arrastre actual ya no cabia: no se graba nada hasta CloseGroup
+    if (overflowed) return;
+
+    if (groupOpen && groupCursor == groupHead && groupHead > groupTail && GroupAt(groupHead - 1).field == field)
+        return;
+
+    // Grupo nuevo: se pierde lo que quedaba por rehacer
+    groupHead = groupCursor;
+    editHead = groupHead > groupTail ? GroupAt(groupHead - 1).first + GroupAt(groupHead - 1).count : editTail;
+
+    if (groupHead - groupTail == groups.size())
+        EvictOldestGroup();
+
+    Group& g = GroupAt(groupHead);
+    g.first = editHead;
+    g.count = 0;
+    g.field = field;
+    groupHead++;
+    groupCursor = groupHead;
+
+    groupOpen = true;
+    overflowed = false;
+}
+
+void CommandJournal::Record(GameObject* object, const Vec3& oldValue, const Vec3& newValue)
+{
+    if (!groupOpen || overflowed) return;
+
+    Group& g = GroupAt(groupHead - 1);
+
+    // Fusion: el mismo objeto en la misma posicion del grupo solo actualiza el valor nuevo
+    if (tickIndex < g.count)
+    {
+        Edit& e = EditAt(g.first + tickIndex);
+        if (e.object == object)
+        {
+            e.newValue = newValue;
+            tickIndex++;
+            return;
+        }
+
+        // La seleccion ha cambiado a mitad del arrastre: se descarta la cola y se regraba
+        g.count = tickIndex;
+        editHead = g.first + g.count;
+    }
+
+    // Ring lleno: se descartan los grupos mas antiguos
+    while (editHead - editTail == edits.size())
+    {
+        if (groupTail == groupHead - 1)
+        {
+            // El grupo actual no cabe en el journal: no se puede deshacer a medias
+            overflowed = true;
+            groupOpen = false;
+            groupHead--;
+            groupCursor = groupHead;
+            editHead = g.first;
+            return;
+        }
+        EvictOldestGroup();
+    }
+
+    Edit& e = EditAt(editHead++);
+    e.object = object;
+    e.oldValue = oldValue;
+    e.newValue = newValue;
+    e.field = g.field;
+    g.count++;
+    tickIndex++;
+}
+
+bool CommandJournal::Undo()
+{
+    if (!CanUndo()) return false;
+    groupOpen = false;
+
+    const Group& g = GroupAt(--groupCursor);
+    for (uint64_t i = g.first + g.count; i-- > g.first; )
+    {
+        const Edit& e = EditAt(i);
+        if (e.object) Write(e.object, e.field, e.oldValue);
+    }
+    return true;
+}
+
+bool CommandJournal::Redo()
+{
+    if (!CanRedo()) return false;
+    groupOpen = false;
+
+    const Group& g = GroupAt(groupCursor++);
+    for (uint64_t i = g.first; i < g.first + g.count; ++i)
+    {
+        const Edit& e = EditAt(i);
+        if (e.object) Write(e.object, e.field, e.newValue);
+    }
+    return true;
+}
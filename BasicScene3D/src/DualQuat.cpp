@@ -0,0 +1,62 @@
+#include "DualQuat.hpp"
+#include <cmath>
+#include <stdexcept>
+
+DualQuat DualQuat::FromTransform(const Transform& t)
+{
+    return FromRotationTranslation(t.rotation, t.position);
+}
+
+DualQuat DualQuat::FromAffine3(const Affine3& M)
+{
+    // Quita la escala de cada columna antes de extraer la rotacion
+    Matrix3x3 R = M.Linear();
+    for (int j = 0; j < 3; ++j)
+    {
+        const double n = std::sqrt(R.At(0, j) * R.At(0, j) + R.At(1, j) * R.At(1, j) + R.At(2, j) * R.At(2, j));
+        const double inv = n > 0.0 ? 1.0 / n : 0.0;
+        for (int i = 0; i < 3; ++i) R.At(i, j) *= inv;
+    }
+    return FromRotationTranslation(Quat::FromMatrix3x3Unchecked(R).Normalized(), M.Translation());
+}
+
+DualQuat DualQuat::FromMatrix4x4(const Matrix4x4& M)
+{
+    if (!M.IsAffine()) throw std::invalid_argument("DualQuat::FromMatrix4x4: matrix is not affine");
+    return FromRotationTranslation(Quat::FromMatrix3x3(M.GetRotationScale()), M.GetTranslation());
+}
+
+Transform DualQuat::ToTransform() const
+{
+    Transform t;
+    t.position = GetTranslation();
+    t.rotation = real;
+    // eulerRotation se mantiene en sincronia con rotation como en SetEulerRotation
+    real.ToEulerZYX(t.eulerRotation.x, t.eulerRotation.y, t.eulerRotation.z);
+    return t;
+}
+
+Affine3 DualQuat::ToAffine3() const
+{
+    return Affine3::FromTRS(GetTranslation(), real.ToMatrix3x3Unchecked(), { 1.0, 1.0, 1.0 });
+}
+
+Matrix4x4 DualQuat::ToMatrix4x4() const
+{
+    return ToAffine3().ToMatrix4x4();
+}
+
+DualQuat DualQuat::Normalized() const
+{
+    const double n2 = real.s * real.s + real.x * real.x + real.y * real.y + real.z * real.z;
+    if (n2 == 0) throw std::invalid_argument("DualQuat::Normalized: zero norm");
+    const double inv = 1.0 / std::sqrt(n2);
+
+    DualQuat q;
+    q.real = { real.s * inv, real.x * inv, real.y * inv, real.z * inv };
+    q.dual = { dual.s * inv, dual.x * inv, dual.y * inv, dual.z * inv };
+
+    const double d = q.real.s * q.dual.s + q.real.x * q.dual.x + q.real.y * q.dual.y + q.real.z * q.dual.z;
+    q.dual = { q.dual.s - d * q.real.s, q.dual.x - d * q.real.x, q.dual.y - d * q.real.y, q.dual.z - d * q.real.z };
+    return q;
+}
\ No newline at end of file
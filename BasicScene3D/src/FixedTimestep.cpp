@@ -0,0 +1,39 @@
+#include "FixedTimestep.hpp"
+#include <cmath>
+#include <stdexcept>
+
+FixedTimestep::FixedTimestep(uint64_t counterFrequency, double hz, int maxSteps)
+    : maxSteps(maxSteps), frequency((double)counterFrequency), step(1.0 / 60.0)
+{
+    if (counterFrequency == 0) throw std::invalid_argument("FixedTimestep: zero counter frequency");
+    SetRate(hz);
+}
+
+void FixedTimestep::Reset(uint64_t counter)
+{
+    last = counter;
+    accumulator = 0.0;
+}
+
+int FixedTimestep::Advance(uint64_t counter)
+{
+    accumulator += (double)(counter - last) / frequency;
+    last = counter;
+
+    int steps = 0;
+    while (accumulator >= step && steps < maxSteps)
+    {
+        accumulator -= step;
+        ++steps;
+    }
+    // Tiempo que no se ha podido simular: se pierde, solo se guarda la fraccion del paso en curso
+    if (accumulator >= step) accumulator = std::fmod(accumulator, step);
+    return steps;
+}
+
+void FixedTimestep::SetRate(double hz)
+{
+    if (hz <= 0.0) throw std::invalid_argument("FixedTimestep::SetRate: rate must be positive");
+    step = 1.0 / hz;
+    if (accumulator >= step) accumulator = 0.0;
+}
\ No newline at end of file
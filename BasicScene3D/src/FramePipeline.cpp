@@ -0,0 +1,65 @@
+#include "FramePipeline.hpp"
+#include <stdexcept>
+#include <utility>
+
+FramePipeline::FramePipeline(std::function<void(int)> produce)
+    : produce(std::move(produce))
+{
+    if (!this->produce) throw std::invalid_argument("FramePipeline: empty produce function");
+    thread = std::thread(&FramePipeline::SimLoop, this);
+}
+
+FramePipeline::~FramePipeline()
+{
+    WaitAndSwap();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    kicked.notify_one();
+    thread.join();
+}
+
+void FramePipeline::Kick()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (requested != completed) throw std::logic_error("FramePipeline::Kick: previous frame still in flight");
+        ++requested;
+    }
+    kicked.notify_one();
+}
+
+void FramePipeline::WaitAndSwap()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return completed == requested; });
+    if (swapped == completed) return;
+    swapped = completed;
+    lock.unlock();
+
+    // El hilo de GL lee Front() sin lock; el de simulacion esta parado hasta el siguiente Kick
+    front.store(1 - front.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+void FramePipeline::SimLoop()
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            kicked.wait(lock, [&] { return stopping || requested != seen; });
+            if (stopping) return;
+            seen = requested;
+        }
+
+        produce(1 - front.load(std::memory_order_acquire));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed = seen;
+        }
+        done.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "FrameWriter.hpp"
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <filesystem>
+
+FrameWriter::FrameWriter(std::string directory, FrameFormat format, std::size_t maxQueued)
+    : directory(std::move(directory)), format(format), maxQueued(maxQueued > 0 ? maxQueued : 1)
+{
+    // --out puede apuntar a un directorio que aun no existe
+    std::error_code ec;
+    if (!this->directory.empty()) std::filesystem::create_directories(this->directory, ec);
+    if (ec) error = "cannot create " + this->directory + ": " + ec.message();
+    thread = std::thread(&FrameWriter::WriterLoop, this);
+}
+
+FrameWriter::~FrameWriter()
+{
+    Close();
+}
+
+void FrameWriter::Submit(std::vector<uint8_t>&& rgba, int width, int height)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return frames.size() < maxQueued || closing; });
+    if (closing) return;
+
+    Frame frame;
+    frame.rgba = std::move(rgba);
+    frame.width = width;
+    frame.height = height;
+    frame.index = submitted++;
+    frames.push_back(std::move(frame));
+    lock.unlock();
+    queued.notify_one();
+}
+
+void FrameWriter::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing) return;
+        closing = true;
+    }
+    queued.notify_one();
+    drained.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+std::size_t FrameWriter::Written() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+std::string FrameWriter::Error() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+void FrameWriter::WriterLoop()
+{
+    std::vector<uint8_t> scratch;
+    for (;;)
+    {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // Al cerrar se vacia la cola antes de salir
+            queued.wait(lock, [this] { return closing || !frames.empty(); });
+            if (frames.empty()) return;
+            frame = std::move(frames.front());
+            frames.pop_front();
+        }
+        drained.notify_one();
+
+        bool failed;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            failed = !error.empty();
+        }
+        if (failed) continue;
+
+        const bool ok = WriteFrame(frame, scratch);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok) ++written;
+    }
+}
+
+bool FrameWriter::WriteFrame(const Frame& frame, std::vector<uint8_t>& scratch)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%05zu.%s", frame.index, format == FrameFormat::PPM ? "ppm" : "rgba");
+    const std::string path = directory.empty() ? std::string(name) : directory + "/" + name;
+
+    // Volteo vertical (y en PPM, quitar el alfa) en una sola pasada
+    const int channels = format == FrameFormat::PPM ? 3 : 4;
+    const std::size_t rowOut = (std::size_t)frame.width * channels;
+    scratch.resize(rowOut * frame.height);
+    for (int y = 0; y < frame.height; ++y)
+    {
+        const uint8_t* src = frame.rgba.data() + (std::size_t)(frame.height - 1 - y) * frame.width * 4;
+        uint8_t* dst = scratch.data() + (std::size_t)y * rowOut;
+        if (channels == 4)
+        {
+            std::memcpy(dst, src, rowOut);
+            continue;
+        }
+        for (int x = 0; x < frame.width; ++x)
+        {
+            dst[x * 3 + 0] = src[x * 4 + 0];
+            dst[x * 3 + 1] = src[x * 4 + 1];
+            dst[x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    bool ok = file != nullptr;
+    if (ok && format == FrameFormat::PPM)
+        ok = std::fprintf(file, "P6\n%d %d\n255\n", frame.width, frame.height) > 0;
+    if (ok)
+        ok = std::fwrite(scratch.data(), 1, scratch.size(), file) == scratch.size();
+    if (file && std::fclose(file) != 0) ok = false;
+
+    if (!ok)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error.empty()) error = "FrameWriter: could not write " + path;
+    }
+    return ok;
+}
\ No newline at end of file
@@ -6,12 +6,44 @@ void GameObject::AddChild(GameObject* child)
 
     child->parent = this;
     children.push_back(child);
+    child->MarkWorldDirty();
 }
 
-Matrix4x4 GameObject::GetGlobalMatrix() const
+const Affine3& GameObject::GetGlobalMatrix() const
 {
+    if (!worldDirty)
+        return worldMatrix;
+
+    if (parent)
+        worldMatrix = parent->GetGlobalMatrix().Multiply(transform.GetLocalMatrix());
+    else
+        worldMatrix = transform.GetLocalMatrix();
+
+    worldDirty = false;
+    return worldMatrix;
+}
+
+const DualQuat& GameObject::GetGlobalDualQuat() const
+{
+    if (!worldDQDirty)
+        return worldDQ;
+
     if (parent)
-        return parent->GetGlobalMatrix().Multiply(transform.GetLocalMatrix());
+        worldDQ = parent->GetGlobalDualQuat().Multiply(DualQuat::FromTransform(transform));
+    else
+        worldDQ = DualQuat::FromTransform(transform);
+
+    worldDQDirty = false;
+    return worldDQ;
+}
 
-    return transform.GetLocalMatrix();
-}
\ No newline at end of file
+void GameObject::MarkWorldDirty()
+{
+    // Por el invariante, un subarbol ya sucio no hace falta recorrerlo. Recursivo: sin reservar
+    // memoria por llamada (se llama una vez por raiz editada en cada tick de arrastre)
+    if (worldDirty && worldDQDirty) return;
+
+    worldDirty = worldDQDirty = true;
+    for (GameObject* child : children)
+        child->MarkWorldDirty();
+}
@@ -0,0 +1,199 @@
+#include "HierarchyView.hpp"
+#include "imgui.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+    bool ContainsNoCase(const std::string& text, const std::string& query)
+    {
+        auto it = std::search(text.begin(), text.end(), query.begin(), query.end(),
+            [](char a, char b) { return std::tolower((unsigned char)a) == std::tolower((unsigned char)b); });
+        return it != text.end();
+    }
+
+    // Aplica las peticiones de BeginMultiSelect/EndMultiSelect; los items se identifican por indice de fila
+    template <typename NodeAt>
+    bool ApplyRequests(ImGuiMultiSelectIO* io, Selection& selection, int count, NodeAt nodeAt)
+    {
+        bool changed = false;
+        for (ImGuiSelectionRequest& req : io->Requests)
+        {
+            if (req.Type == ImGuiSelectionRequestType_SetAll)
+            {
+                selection.Clear();
+                if (req.Selected)
+                    for (int i = 0; i < count; ++i) selection.Add(nodeAt(i));
+                changed = true;
+            }
+            else if (req.Type == ImGuiSelectionRequestType_SetRange)
+            {
+                for (int i = (int)req.RangeFirstItem; i <= (int)req.RangeLastItem; ++i)
+                {
+                    if (req.Selected) selection.Add(nodeAt(i));
+                    else selection.Remove(nodeAt(i));
+                }
+                changed = true;
+            }
+        }
+        return changed;
+    }
+}
+
+void HierarchyView::SetExpanded(GameObject* node, bool open)
+{
+    if (open) expanded.insert(node);
+    else expanded.erase(node);
+    rowsDirty = true;
+}
+
+void HierarchyView::Reveal(GameObject* node)
+{
+    for (GameObject* p = node ? node->parent : nullptr; p; p = p->parent)
+        SetExpanded(p, true);
+}
+
+void HierarchyView::RebuildRows(const std::vector<GameObject*>& roots)
+{
+    rows.clear();
+
+    // Recorrido iterativo en preorden; solo baja por los nodos expandidos
+    std::vector<Row> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+        if (*it) stack.push_back({ *it, 0 });
+
+    while (!stack.empty())
+    {
+        Row row = stack.back();
+        stack.pop_back();
+        rows.push_back(row);
+
+        if (!row.node->children.empty() && IsExpanded(row.node))
+        {
+            const auto& children = row.node->children;
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+                stack.push_back({ *it, row.depth + 1 });
+        }
+    }
+
+    rowsDirty = false;
+}
+
+void HierarchyView::UpdateSearch(const std::vector<GameObject*>& roots)
+{
+    const std::string query = searchBuffer;
+
+    // Si la busqueda solo se ha alargado basta con filtrar los resultados anteriores
+    const bool refine = !searchDirty && !lastQuery.empty() &&
+        query.size() >= lastQuery.size() && query.compare(0, lastQuery.size(), lastQuery) == 0;
+
+    if (refine)
+    {
+        matches.erase(std::remove_if(matches.begin(), matches.end(),
+            [&](GameObject* node) { return !ContainsNoCase(node->name, query); }), matches.end());
+    }
+    else
+    {
+        matches.clear();
+        std::vector<GameObject*> stack(roots.rbegin(), roots.rend());
+        while (!stack.empty())
+        {
+            GameObject* node = stack.back();
+            stack.pop_back();
+            if (!node) continue;
+
+            if (ContainsNoCase(node->name, query)) matches.push_back(node);
+            stack.insert(stack.end(), node->children.rbegin(), node->children.rend());
+        }
+    }
+
+    lastQuery = query;
+    searchDirty = false;
+}
+
+bool HierarchyView::Draw(const std::vector<GameObject*>& roots, Selection& selection)
+{
+    bool selectionChanged = false;
+
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    bool queryChanged = ImGui::InputTextWithHint("##search", "Search...", searchBuffer, sizeof(searchBuffer));
+    const bool searching = searchBuffer[0] != '\0';
+
+    if (searching)
+    {
+        if (queryChanged || searchDirty) UpdateSearch(roots);
+
+        // Seleccion por consulta: todos los resultados de la busqueda
+        if (ImGui::Button("Select Matches"))
+        {
+            selection.Clear();
+            for (GameObject* node : matches) selection.Add(node);
+            selectionChanged = true;
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("%d found", (int)matches.size());
+    }
+    else if (rowsDirty)
+    {
+        RebuildRows(roots);
+    }
+
+    ImGui::BeginChild("##hierarchy_rows", ImVec2(0, 0), ImGuiChildFlags_None);
+
+    const int count = searching ? (int)matches.size() : (int)rows.size();
+    auto nodeAt = [&](int i) { return searching ? matches[i] : rows[i].node; };
+
+    const ImGuiMultiSelectFlags msFlags = ImGuiMultiSelectFlags_BoxSelect1d | ImGuiMultiSelectFlags_ClearOnEscape |
+        ImGuiMultiSelectFlags_ClearOnClickVoid;
+    ImGuiMultiSelectIO* msIO = ImGui::BeginMultiSelect(msFlags, (int)selection.Size(), count);
+    selectionChanged |= ApplyRequests(msIO, selection, count, nodeAt);
+
+    const float indent = ImGui::GetStyle().IndentSpacing;
+    bool toggled = false;
+
+    ImGuiListClipper clipper;
+    clipper.Begin(count);
+    if (msIO->RangeSrcItem != -1) clipper.IncludeItemByIndex((int)msIO->RangeSrcItem);
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            GameObject* node = nodeAt(i);
+            ImGui::SetNextItemSelectionUserData(i);
+
+            if (searching)
+            {
+                ImGui::PushID(node);
+                ImGui::Selectable(node->name.c_str(), selection.Contains(node));
+                ImGui::PopID();
+                continue;
+            }
+
+            ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_OpenOnDoubleClick |
+                ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanAvailWidth;
+            if (selection.Contains(node)) flags |= ImGuiTreeNodeFlags_Selected;
+            if (node->children.empty()) flags |= ImGuiTreeNodeFlags_Leaf;
+
+            // Sin TreePush: la sangria se aplica a mano segun la profundidad
+            ImGui::SetCursorPosX(ImGui::GetCursorPosX() + rows[i].depth * indent);
+            ImGui::SetNextItemOpen(IsExpanded(node));
+            ImGui::TreeNodeEx((void*)node, flags, "%s", node->name.c_str());
+
+            if (ImGui::IsItemToggledOpen())
+            {
+                // No se reconstruye aqui para no invalidar 'rows' durante el clipper
+                if (IsExpanded(node)) expanded.erase(node);
+                else expanded.insert(node);
+                toggled = true;
+            }
+        }
+    }
+
+    msIO = ImGui::EndMultiSelect();
+    selectionChanged |= ApplyRequests(msIO, selection, count, nodeAt);
+
+    if (toggled) rowsDirty = true;
+
+    ImGui::EndChild();
+    return selectionChanged;
+}
@@ -0,0 +1,97 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned workers)
+{
+    if (workers == 0)
+    {
+        const unsigned hw = std::thread::hardware_concurrency();
+        workers = hw > 1 ? hw - 1 : 1;
+    }
+
+    threads.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i)
+        threads.emplace_back(&JobSystem::WorkerLoop, this);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+void JobSystem::ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& fn)
+{
+    if (count == 0) return;
+    grain = std::max<std::size_t>(grain, 1);
+
+    const std::size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || threads.empty())
+    {
+        fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        jobGrain = grain;
+        nextChunk.store(0, std::memory_order_relaxed);
+        pending.store(chunks, std::memory_order_release);
+        ++generation;
+    }
+    wake.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0 && active == 0; });
+    job = nullptr;
+}
+
+void JobSystem::RunChunks()
+{
+    const std::size_t chunks = (jobCount + jobGrain - 1) / jobGrain;
+    for (;;)
+    {
+        const std::size_t c = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (c >= chunks) return;
+
+        const std::size_t begin = c * jobGrain;
+        (*job)(begin, std::min(begin + jobGrain, jobCount));
+
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // Ultimo trozo: despierta al que espera en ParallelFor
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.notify_all();
+        }
+    }
+}
+
+void JobSystem::WorkerLoop()
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || (generation != seen && pending.load(std::memory_order_acquire) > 0); });
+            if (stopping) return;
+            seen = generation;
+            ++active;
+        }
+        RunChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --active;
+        }
+        finished.notify_all();
+    }
+}
\ No newline at end of file
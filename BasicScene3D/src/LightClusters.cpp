@@ -0,0 +1,196 @@
+#include "LightClusters.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLUSTERS_SSE 1
+#include <xmmintrin.h>
+#endif
+
+void LightClusters::Begin(const Vec3& origin)
+{
+    this->origin = origin;
+    lights.clear();
+    boundsX.clear();
+    boundsY.clear();
+    boundsZ.clear();
+    boundsRadius.clear();
+}
+
+void LightClusters::AddLight(const Affine3& world, const Light& light)
+{
+    if (light.type == LightType::None || light.range <= 0.0 || lights.size() >= maxLights) return;
+
+    const Vec3 worldPosition = world.Translation();
+    const Vec3 position = { worldPosition.x - origin.x, worldPosition.y - origin.y, worldPosition.z - origin.z };
+    const Vec3 direction = world.TransformVector({ 0, 0, -1 }).Normalize();
+    const bool spot = light.type == LightType::Spot;
+
+    GpuLight g;
+    g.position[0] = (float)position.x; g.position[1] = (float)position.y; g.position[2] = (float)position.z;
+    g.range = (float)light.range;
+    g.color[0] = (float)(light.color.x * light.intensity);
+    g.color[1] = (float)(light.color.y * light.intensity);
+    g.color[2] = (float)(light.color.z * light.intensity);
+    g.direction[0] = (float)direction.x; g.direction[1] = (float)direction.y; g.direction[2] = (float)direction.z;
+    g.cosInner = spot ? (float)std::cos(light.innerAngle) : -1.0f;
+    // smoothstep necesita cosOuter < cosInner
+    g.cosOuter = spot ? std::min((float)std::cos(light.outerAngle), g.cosInner - 1e-4f) : -2.0f;
+    lights.push_back(g);
+
+    // Esfera que contiene la zona iluminada: el alcance, o para un foco la que envuelve su cono
+    Vec3 center = position;
+    double radius = light.range;
+    const double halfPi = 1.5707963267948966;
+    const double angle = light.outerAngle;
+    if (spot && angle < halfPi * 0.5)
+    {
+        radius = light.range / (2.0 * std::cos(angle));
+        center = { position.x + direction.x * radius, position.y + direction.y * radius, position.z + direction.z * radius };
+    }
+    else if (spot && angle < halfPi)
+    {
+        const double along = std::cos(angle) * light.range;
+        radius = std::sin(angle) * light.range;
+        center = { position.x + direction.x * along, position.y + direction.y * along, position.z + direction.z * along };
+    }
+    boundsX.push_back((float)center.x);
+    boundsY.push_back((float)center.y);
+    boundsZ.push_back((float)center.z);
+    boundsRadius.push_back((float)radius);
+}
+
+void LightClusters::Build(const Camera& camera, JobSystem& jobs)
+{
+    const double nearZ = camera.nearPlane;
+    const double farZ = camera.farPlane;
+    const double logRatio = std::log(farZ / nearZ);
+    depthScale = static_cast<float>(DimZ / logRatio);
+    depthBias = static_cast<float>(-std::log(nearZ) * DimZ / logRatio);
+
+    // Solo se pasan a vista los centros; el radio no cambia con una transformacion rigida
+    Transform eye = camera.transform;
+    eye.position = { eye.position.x - origin.x, eye.position.y - origin.y, eye.position.z - origin.z };
+    const Affine3 view = eye.GetLocalMatrix().InverseRigid();
+    const std::size_t n = lights.size();
+    viewX.resize(n);
+    viewY.resize(n);
+    viewZ.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Vec3 c = view.TransformPoint({ boundsX[i], boundsY[i], boundsZ[i] });
+        viewX[i] = (float)c.x;
+        viewY[i] = (float)c.y;
+        viewZ[i] = (float)c.z;
+    }
+
+    const float tanX = static_cast<float>(std::tan(camera.fovHorizontal * 0.5));
+    const float tanY = static_cast<float>(tanX / camera.aspectRatio);
+    jobs.ParallelFor(DimZ, 1, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t s = begin; s < end; ++s)
+        {
+            const float zNear = static_cast<float>(nearZ * std::pow(farZ / nearZ, double(s) / DimZ));
+            const float zFar = static_cast<float>(nearZ * std::pow(farZ / nearZ, double(s + 1) / DimZ));
+            AssignSlice(static_cast<uint32_t>(s), zNear, zFar, tanX, tanY);
+        }
+    });
+
+    // Cada slice tiene offsets locales a su lista: se concatenan en orden
+    indices.clear();
+    for (uint32_t s = 0; s < DimZ; ++s)
+    {
+        const SliceScratch& scratch = slices[s];
+        const uint32_t base = static_cast<uint32_t>(indices.size());
+        for (uint32_t c = s * DimX * DimY; c < (s + 1) * DimX * DimY; ++c)
+        {
+            const std::size_t offset = base + grid[c * 2];
+            const std::size_t room = offset < maxIndices ? maxIndices - offset : 0;
+            grid[c * 2] = room > 0 ? static_cast<uint32_t>(offset) : 0;
+            grid[c * 2 + 1] = static_cast<uint32_t>(std::min<std::size_t>(grid[c * 2 + 1], room));
+        }
+        const std::size_t count = std::min(scratch.indices.size(), maxIndices - std::min(maxIndices, indices.size()));
+        indices.insert(indices.end(), scratch.indices.begin(), scratch.indices.begin() + count);
+    }
+}
+
+void LightClusters::AssignSlice(uint32_t slice, float zNear, float zFar, float tanX, float tanY)
+{
+    SliceScratch& s = slices[slice];
+    s.x.clear();
+    s.y.clear();
+    s.z.clear();
+    s.radius2.clear();
+    s.light.clear();
+    s.indices.clear();
+
+    // La camara mira a -z: el slice ocupa z en [-zFar, -zNear]
+    for (std::size_t i = 0; i < viewZ.size(); ++i)
+    {
+        const float r = boundsRadius[i];
+        if (viewZ[i] - r > -zNear || viewZ[i] + r < -zFar) continue;
+        s.x.push_back(viewX[i]);
+        s.y.push_back(viewY[i]);
+        s.z.push_back(viewZ[i]);
+        s.radius2.push_back(r * r);
+        s.light.push_back(static_cast<uint32_t>(i));
+    }
+    while (s.light.size() % 4 != 0)
+    {
+        s.x.push_back(0.0f);
+        s.y.push_back(0.0f);
+        s.z.push_back(0.0f);
+        s.radius2.push_back(-1.0f);
+        s.light.push_back(0);
+    }
+
+    const float minZ = -zFar, maxZ = -zNear;
+    for (uint32_t y = 0; y < DimY; ++y)
+    {
+        // La caja del cluster envuelve el tile en las dos caras del slice
+        const float ndcY0 = -1.0f + 2.0f * y / DimY, ndcY1 = -1.0f + 2.0f * (y + 1) / DimY;
+        const float minY = std::min(ndcY0 * zNear, ndcY0 * zFar) * tanY;
+        const float maxY = std::max(ndcY1 * zNear, ndcY1 * zFar) * tanY;
+
+        for (uint32_t x = 0; x < DimX; ++x)
+        {
+            const float ndcX0 = -1.0f + 2.0f * x / DimX, ndcX1 = -1.0f + 2.0f * (x + 1) / DimX;
+            const float minX = std::min(ndcX0 * zNear, ndcX0 * zFar) * tanX;
+            const float maxX = std::max(ndcX1 * zNear, ndcX1 * zFar) * tanX;
+
+            const uint32_t cluster = x + DimX * (y + DimY * slice);
+            const std::size_t first = s.indices.size();
+
+            // Distancia^2 de cada centro a la caja contra radio^2, 4 luces a la vez
+#ifdef CLUSTERS_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 x0 = _mm_set1_ps(minX), x1 = _mm_set1_ps(maxX);
+            const __m128 y0 = _mm_set1_ps(minY), y1 = _mm_set1_ps(maxY);
+            const __m128 z0 = _mm_set1_ps(minZ), z1 = _mm_set1_ps(maxZ);
+            for (std::size_t i = 0; i < s.light.size(); i += 4)
+            {
+                const __m128 cx = _mm_loadu_ps(&s.x[i]);
+                const __m128 cy = _mm_loadu_ps(&s.y[i]);
+                const __m128 cz = _mm_loadu_ps(&s.z[i]);
+                const __m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(x0, cx), zero), _mm_max_ps(_mm_sub_ps(cx, x1), zero));
+                const __m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(y0, cy), zero), _mm_max_ps(_mm_sub_ps(cy, y1), zero));
+                const __m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(z0, cz), zero), _mm_max_ps(_mm_sub_ps(cz, z1), zero));
+                const __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                const int mask = _mm_movemask_ps(_mm_cmple_ps(d2, _mm_loadu_ps(&s.radius2[i])));
+                for (int b = 0; b < 4; ++b)
+                    if (mask & (1 << b)) s.indices.push_back(s.light[i + b]);
+            }
+#else
+            for (std::size_t i = 0; i < s.light.size(); ++i)
+            {
+                const float dx = std::max(minX - s.x[i], 0.0f) + std::max(s.x[i] - maxX, 0.0f);
+                const float dy = std::max(minY - s.y[i], 0.0f) + std::max(s.y[i] - maxY, 0.0f);
+                const float dz = std::max(minZ - s.z[i], 0.0f) + std::max(s.z[i] - maxZ, 0.0f);
+                if (dx * dx + dy * dy + dz * dz <= s.radius2[i]) s.indices.push_back(s.light[i]);
+            }
+#endif
+            grid[cluster * 2] = static_cast<uint32_t>(first);
+            grid[cluster * 2 + 1] = static_cast<uint32_t>(s.indices.size() - first);
+        }
+    }
+}
\ No newline at end of file
@@ -6,16 +6,6 @@
 
 // ------------------ Vec3 -------------------------
 
-double Vec3::Dot(const Vec3& a, const Vec3& b)
-{
-    return a.x * b.x + a.y * b.y + a.z * b.z;
-}
-
-Vec3 Vec3::Cross(const Vec3& a, const Vec3& b)
-{
-    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
-}
-
 double Vec3::Norm() const
 {
     return std::sqrt(Dot(*this, *this));
@@ -30,61 +20,6 @@ Vec3 Vec3::Normalize() const
 
 // ------------------ Matrix3x3 ---------------------
 
-Matrix3x3 Matrix3x3::Identity()
-{
-    Matrix3x3 I;
-    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1;
-    return I;
-}
-
-Vec3 Matrix3x3::Multiply(const Vec3& x) const
-{
-    // y = A * x
-    Vec3 y;
-    y.x = At(0, 0) * x.x + At(0, 1) * x.y + At(0, 2) * x.z;
-    y.y = At(1, 0) * x.x + At(1, 1) * x.y + At(1, 2) * x.z;
-    y.z = At(2, 0) * x.x + At(2, 1) * x.y + At(2, 2) * x.z;
-    return y;
-}
-
-Matrix3x3 Matrix3x3::Multiply(const Matrix3x3& B) const
-{
-    Matrix3x3 C{};
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            double s = 0.0;
-            for (int k = 0; k < 3; ++k) {
-                s += At(i, k) * B.At(k, j);
-            }
-            C.At(i, j) = s;
-        }
-    }
-    return C;
-}
-
-double Matrix3x3::Det() const
-{
-    const double a = At(0, 0), b = At(0, 1), c = At(0, 2);
-    const double d = At(1, 0), e = At(1, 1), f = At(1, 2);
-    const double g = At(2, 0), h = At(2, 1), i = At(2, 2);
-    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
-}
-
-Matrix3x3 Matrix3x3::Transposed() const
-{
-    Matrix3x3 R{};
-    for (int i = 0; i < 3; ++i)
-        for (int j = 0; j < 3; ++j)
-            R.At(i, j) = At(j, i);
-    return R;
-}
-
-double Matrix3x3::Trace() const
-{
-    return At(0, 0) + At(1, 1) + At(2, 2);
-}
-
-
 Matrix3x3 Matrix3x3::RotationAxisAngle(const Vec3& u_in, double phi)
 {
     Vec3 u = u_in.Normalize();
@@ -128,11 +63,6 @@ bool Matrix3x3::IsRotation() const
     return true;
 }
 
-Vec3 Matrix3x3::Rotate(const Vec3& v) const
-{
-    return Multiply(v);
-}
-
 void Matrix3x3::ToAxisAngle(Vec3& axis, double& angle) const
 {
     if (!IsRotation()) throw std::invalid_argument("ToAxisAngle: matrix is not a rotation");
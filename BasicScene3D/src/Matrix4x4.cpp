@@ -1,213 +1,17 @@
 #include "Matrix4x4.hpp"
+#include "Affine3.hpp"
 #include <cmath>
 #include <stdexcept>
 
 #define TOL 1e-6
 
-Matrix4x4 Matrix4x4::Identity()
-{
-    Matrix4x4 I;
-    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1; I.At(3, 3) = 1;
-    return I;
-}
-
-Matrix4x4 Matrix4x4::Multiply(const Matrix4x4& B) const
-{
-    Matrix4x4 C{};
-    for (int i = 0; i < 4; ++i) {
-        for (int j = 0; j < 4; ++j) {
-            double sum = 0.0;
-            for (int k = 0; k < 4; ++k) {
-                sum += At(i, k) * B.At(k, j);
-            }
-            C.At(i, j) = sum;
-        }
-    }
-    return C;
-}
-
-Vec4 Matrix4x4::Multiply(const Vec4& v) const
-{
-    Vec4 res;
-    res.x = At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z + At(0, 3) * v.w;
-    res.y = At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z + At(1, 3) * v.w;
-    res.z = At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z + At(2, 3) * v.w;
-    res.w = At(3, 0) * v.x + At(3, 1) * v.y + At(3, 2) * v.z + At(3, 3) * v.w;
-    return res;
-}
-
 // --------------------------------------------------------------------------
 // TODO LAB 3
 // --------------------------------------------------------------------------
 
-bool Matrix4x4::IsAffine() const
-{
-    if (this->At(3, 0) != 0) return false;
-    if (this->At(3, 1) != 0) return false;
-    if (this->At(3, 2) != 0) return false;
-    if (this->At(3, 3) != 1) return false;
-
-    return true;
-}
-
-Vec3 Matrix4x4::TransformPoint(const Vec3& p) const
-{
-    Vec4 temp;
-    Vec3 res;
-
-    temp.x = p.x;
-    temp.y = p.y;
-    temp.z = p.z;
-    temp.w = 1;
-
-    temp = Multiply(temp);
-
-    res.x = temp.x;
-    res.y = temp.y;
-    res.z = temp.z;
-
-    return res;
-}
-
-Vec3 Matrix4x4::TransformVector(const Vec3& v) const
-{
-    Vec4 temp;
-    Vec3 res;
-
-    temp.x = v.x;
-    temp.y = v.y;
-    temp.z = v.z;
-    temp.w = 0;
-
-    temp = Multiply(temp);
-
-    res.x = temp.x;
-    res.y = temp.y;
-    res.z = temp.z;
-
-    return res;
-}
-
-Matrix4x4 Matrix4x4::Translate(const Vec3& t)
-{
-    Matrix4x4 M;
-    M.At(0, 0) = 1;
-    M.At(0, 1) = 0;
-    M.At(0, 2) = 0;
-    M.At(0, 3) = t.x;
-    M.At(1, 0) = 0;
-    M.At(1, 1) = 1;
-    M.At(1, 2) = 0;
-    M.At(1, 3) = t.y;
-    M.At(2, 0) = 0;
-    M.At(2, 1) = 0;
-    M.At(2, 2) = 1;
-    M.At(2, 3) = t.z;
-    M.At(3, 0) = 0;
-    M.At(3, 1) = 0;
-    M.At(3, 2) = 0;
-    M.At(3, 3) = 1;
-
-    return M;
-}
-
-Matrix4x4 Matrix4x4::Scale(const Vec3& s)
-{
-    Matrix4x4 M;
-
-    M.At(0, 0) = s.x;
-    M.At(0, 1) = 0;
-    M.At(0, 2) = 0;
-    M.At(0, 3) = 0;
-    M.At(1, 0) = 0;
-    M.At(1, 1) = s.y;
-    M.At(1, 2) = 0;
-    M.At(1, 3) = 0;
-    M.At(2, 0) = 0;
-    M.At(2, 1) = 0;
-    M.At(2, 2) = s.z;
-    M.At(2, 3) = 0;
-    M.At(3, 0) = 0;
-    M.At(3, 1) = 0;
-    M.At(3, 2) = 0;
-    M.At(3, 3) = 1;
-    return M;
-}
-
-Matrix4x4 Matrix4x4::Rotate(const Matrix3x3& R)
-{
-    Matrix4x4 M;
-    M.At(0, 0) = R.At(0, 0);
-    M.At(0, 1) = R.At(0, 1);
-    M.At(0, 2) = R.At(0, 2);
-    M.At(0, 3) = 0;
-    M.At(1, 0) = R.At(1, 0);
-    M.At(1, 1) = R.At(1, 1);
-    M.At(1, 2) = R.At(1, 2);
-    M.At(1, 3) = 0;
-    M.At(2, 0) = R.At(2, 0);
-    M.At(2, 1) = R.At(2, 1);
-    M.At(2, 2) = R.At(2, 2);
-    M.At(2, 3) = 0;
-    M.At(3, 0) = 0;
-    M.At(3, 1) = 0;
-    M.At(3, 2) = 0;
-    M.At(3, 3) = 1;
-    return M;
-}
-
 Matrix4x4 Matrix4x4::Rotate(const Quat& q)
 {
-    Matrix4x4 M;
-    Matrix3x3 R;
-
-    R = q.ToMatrix3x3();
-
-    M.At(0, 0) = R.At(0, 0);
-    M.At(0, 1) = R.At(0, 1);
-    M.At(0, 2) = R.At(0, 2);
-    M.At(0, 3) = 0;
-    M.At(1, 0) = R.At(1, 0);
-    M.At(1, 1) = R.At(1, 1);
-    M.At(1, 2) = R.At(1, 2);
-    M.At(1, 3) = 0;
-    M.At(2, 0) = R.At(2, 0);
-    M.At(2, 1) = R.At(2, 1);
-    M.At(2, 2) = R.At(2, 2);
-    M.At(2, 3) = 0;
-    M.At(3, 0) = 0;
-    M.At(3, 1) = 0;
-    M.At(3, 2) = 0;
-    M.At(3, 3) = 1;
-
-    return M;
-}
-
-Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s)
-{
-    Matrix4x4 M = Matrix4x4::Identity();
-
-    
-    M.At(0, 0) = R.At(0, 0) * s.x;
-    M.At(1, 0) = R.At(1, 0) * s.x;
-    M.At(2, 0) = R.At(2, 0) * s.x;
-
-    
-    M.At(0, 1) = R.At(0, 1) * s.y;
-    M.At(1, 1) = R.At(1, 1) * s.y;
-    M.At(2, 1) = R.At(2, 1) * s.y;
-
-    
-    M.At(0, 2) = R.At(0, 2) * s.z;
-    M.At(1, 2) = R.At(1, 2) * s.z;
-    M.At(2, 2) = R.At(2, 2) * s.z;
-
-    
-    M.At(0, 3) = t.x;
-    M.At(1, 3) = t.y;
-    M.At(2, 3) = t.z;
-
-    return M;
+    return Rotate(q.ToMatrix3x3());
 }
 
 Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Quat& q, const Vec3& s)
@@ -215,75 +19,49 @@ Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Quat& q, const Vec3& s)
     return FromTRS(t, q.ToMatrix3x3(), s);
 }
 
+// Las dos pasan por Affine3: sin fila constante ni comprobacion IsAffine() en Release
 Matrix4x4 Matrix4x4::InverseTR() const
 {
-    if (!IsAffine())
-        throw std::runtime_error("La matriz no es afn");
-
-    Matrix3x3 R = GetRotationScale();
-    Vec3 t = GetTranslation();
-
-    Matrix3x3 Rt = R.Transposed();
-
-    Vec3 tInv = Rt * Vec3{ -t.x, -t.y, -t.z };
-
-    Matrix4x4 M = Matrix4x4::Identity();
-    M.SetRotation(Rt);
-    M.SetTranslation(tInv);
-
-    return M;
+    return Affine3::FromMatrix4x4(*this).InverseRigid().ToMatrix4x4();
 }
 
 Matrix4x4 Matrix4x4::InverseTRS() const
 {
-    if (!IsAffine())
-        throw std::runtime_error("La matriz no es afn");
-
-    Vec3 s = GetScale();
-    Matrix3x3 RS = GetRotationScale();
-    Vec3 t = GetTranslation();
-
-    Matrix3x3 SInv;
-    SInv.At(0, 0) = 1.0 / s.x;
-    SInv.At(1, 1) = 1.0 / s.y;
-    SInv.At(2, 2) = 1.0 / s.z;
-
-    Matrix3x3 R = RS * SInv;
-    Matrix3x3 Rt = R.Transposed();
-
-    Matrix3x3 RSInv = SInv * Rt;
-    Vec3 tInv = RSInv * Vec3{ -t.x, -t.y, -t.z };
-
-    Matrix4x4 M = Matrix4x4::Identity();
-    M.SetRotationScale(RSInv);
-    M.SetTranslation(tInv);
-
-    return M;
+    return Affine3::FromMatrix4x4(*this).Inverse().ToMatrix4x4();
 }
 
-Vec3 Matrix4x4::GetTranslation() const
+Matrix4x4 Matrix4x4::Inverse() const
 {
-    Vec3 res;
-    res.x = At(0, 3);
-    res.y = At(1, 3);
-    res.z = At(2, 3);
-    return res;
-}
+    // Inversa general por cofactores (sirve para matrices proyectivas, p.ej. inversa de view-projection)
+    const double* a = m;
+    Matrix4x4 inv;
+    double* o = inv.m;
 
-Matrix3x3 Matrix4x4::GetRotationScale() const
-{
-    Matrix3x3 M;
-    M.At(0, 0) = At(0, 0);
-    M.At(0, 1) = At(0, 1);
-    M.At(0, 2) = At(0, 2);
-    M.At(1, 0) = At(1, 0);
-    M.At(1, 1) = At(1, 1);
-    M.At(1, 2) = At(1, 2);
-    M.At(2, 0) = At(2, 0);
-    M.At(2, 1) = At(2, 1);
-    M.At(2, 2) = At(2, 2);
+    o[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    o[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    o[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    o[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    o[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    o[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    o[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    o[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    o[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    o[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    o[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    o[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    o[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    o[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    o[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    o[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
 
-    return M;
+    double det = a[0] * o[0] + a[1] * o[4] + a[2] * o[8] + a[3] * o[12];
+    if (std::fabs(det) < 1e-12)
+        throw std::runtime_error("Matrix4x4::Inverse: singular matrix");
+
+    const double invDet = 1.0 / det;
+    for (int i = 0; i < 16; ++i) o[i] *= invDet;
+
+    return inv;
 }
 
 Vec3 Matrix4x4::GetScale() const
@@ -298,13 +76,10 @@ Vec3 Matrix4x4::GetScale() const
     s.y = std::sqrt(c1x * c1x + c1y * c1y + c1z * c1z);
     s.z = std::sqrt(c2x * c2x + c2y * c2y + c2z * c2z);
 
-    Matrix3x3 R;
-    R.At(0, 0) = c0x / s.x; R.At(1, 0) = c0y / s.x; R.At(2, 0) = c0z / s.x;
-    R.At(0, 1) = c1x / s.y; R.At(1, 1) = c1y / s.y; R.At(2, 1) = c1z / s.y;
-    R.At(0, 2) = c2x / s.z; R.At(1, 2) = c2y / s.z; R.At(2, 2) = c2z / s.z;
+    // Dividir las columnas por normas positivas no cambia el signo del determinante:
+    // basta el de la parte 3x3 sin normalizar
+    double det = c0x * (c1y * c2z - c2y * c1z) - c1x * (c0y * c2z - c2y * c0z) + c2x * (c0y * c1z - c1y * c0z);
 
-    double det = R.At(0, 0) * (R.At(1, 1) * R.At(2, 2) - R.At(1, 2) * R.At(2, 1)) - R.At(0, 1) * (R.At(1, 0) * R.At(2, 2) - R.At(1, 2) * R.At(2, 0)) + R.At(0, 2) * (R.At(1, 0) * R.At(2, 1) - R.At(1, 1) * R.At(2, 0));
-    
     //Miramos si la escala es negativa. Hemos escogido el eje X para corregir la rotacin.
     if (det < 0) {
         s.x = -s.x;
@@ -315,7 +90,18 @@ Vec3 Matrix4x4::GetScale() const
 
 Matrix3x3 Matrix4x4::GetRotation() const
 {
-    Vec3 s = GetScale();
+    return GetRotation(GetScale());
+}
+
+void Matrix4x4::Decompose(Vec3& t, Matrix3x3& R, Vec3& s) const
+{
+    t = GetTranslation();
+    s = GetScale();
+    R = GetRotation(s);
+}
+
+Matrix3x3 Matrix4x4::GetRotation(const Vec3& s) const
+{
     Matrix3x3 R;
 
     R.At(0, 0) = At(0, 0) / s.x;
@@ -335,15 +121,9 @@ Matrix3x3 Matrix4x4::GetRotation() const
 
 Quat Matrix4x4::GetRotationQuat() const
 {
+    // GetRotation ya devuelve una rotacion por construccion: no hace falta validarla
     Matrix3x3 R = GetRotation();
-    return Quat::FromMatrix3x3(R);
-}
-
-void Matrix4x4::SetTranslation(const Vec3& t)
-{
-    At(0, 3) = t.x;
-    At(1, 3) = t.y;
-    At(2, 3) = t.z;
+    return Quat::FromMatrix3x3Unchecked(R).Normalized();
 }
 
 void Matrix4x4::SetScale(const Vec3& s)
@@ -385,21 +165,6 @@ void Matrix4x4::SetRotation(const Quat& q)
     SetRotation(q.ToMatrix3x3());
 }
 
-void Matrix4x4::SetRotationScale(const Matrix3x3& RS)
-{
-    At(0, 0) = RS.At(0, 0);
-    At(0, 1) = RS.At(0, 1);
-    At(0, 2) = RS.At(0, 2);
-
-    At(1, 0) = RS.At(1, 0);
-    At(1, 1) = RS.At(1, 1);
-    At(1, 2) = RS.At(1, 2);
-
-    At(2, 0) = RS.At(2, 0);
-    At(2, 1) = RS.At(2, 1);
-    At(2, 2) = RS.At(2, 2);
-}
-
 Matrix4x4 Matrix4x4::Perspective(double left, double right, double bottom, double top, double nearPlane, double farPlane)
 {
     Matrix4x4 M{};
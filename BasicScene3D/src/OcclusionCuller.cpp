@@ -0,0 +1,202 @@
+#include "OcclusionCuller.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+// Por delante de este w los vertices se consideran detras de la camara
+#define NEAR_W 1e-4
+
+void OcclusionCuller::Begin(const Matrix4x4& vp)
+{
+    viewProj = vp;
+    vertices.clear();
+    indices.clear();
+    triangles.clear();
+}
+
+void OcclusionCuller::AddOccluder(const Affine3& world, const float* positions, const unsigned int* idx, int indexCount)
+{
+    const unsigned int base = static_cast<unsigned int>(vertices.size());
+    unsigned int maxIndex = 0;
+    for (int i = 0; i < indexCount; ++i)
+    {
+        indices.push_back(base + idx[i]);
+        maxIndex = std::max(maxIndex, idx[i]);
+    }
+    for (unsigned int v = 0; v <= maxIndex && indexCount > 0; ++v)
+        vertices.push_back(world.TransformPoint({ positions[v * 3], positions[v * 3 + 1], positions[v * 3 + 2] }));
+}
+
+void OcclusionCuller::Rasterize(JobSystem& jobs)
+{
+    // Proyeccion: los triangulos que cruzan el plano de la camara se descartan (solo se pierde oclusion)
+    const std::size_t triCount = indices.size() / 3;
+    triangles.resize(triCount);
+    std::vector<uint8_t> keep(triCount, 0);
+
+    jobs.ParallelFor(triCount, 256, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t t = begin; t < end; ++t)
+        {
+            ScreenTriangle& st = triangles[t];
+            bool valid = true;
+            for (int k = 0; k < 3 && valid; ++k)
+            {
+                const Vec3& p = vertices[indices[t * 3 + k]];
+                const Vec4 h = viewProj.Multiply(Vec4(p.x, p.y, p.z, 1.0));
+                if (h.w <= NEAR_W) { valid = false; break; }
+                const double invW = 1.0 / h.w;
+                st.x[k] = static_cast<float>((h.x * invW * 0.5 + 0.5) * Width);
+                st.y[k] = static_cast<float>((h.y * invW * 0.5 + 0.5) * Height);
+                st.z[k] = static_cast<float>(h.z * invW * 0.5 + 0.5);
+            }
+            if (!valid) continue;
+
+            // Orientacion comun (se rasterizan las dos caras)
+            const float area = (st.x[1] - st.x[0]) * (st.y[2] - st.y[0]) - (st.x[2] - st.x[0]) * (st.y[1] - st.y[0]);
+            if (area == 0.0f) continue;
+            if (area < 0.0f)
+            {
+                std::swap(st.x[1], st.x[2]);
+                std::swap(st.y[1], st.y[2]);
+                std::swap(st.z[1], st.z[2]);
+            }
+
+            const float minY = std::min({ st.y[0], st.y[1], st.y[2] });
+            const float maxY = std::max({ st.y[0], st.y[1], st.y[2] });
+            st.minY = std::max(0, static_cast<int>(std::floor(minY)));
+            st.maxY = std::min(Height - 1, static_cast<int>(std::ceil(maxY)));
+            if (st.minY > st.maxY) continue;
+            keep[t] = 1;
+        }
+    });
+
+    std::size_t n = 0;
+    for (std::size_t t = 0; t < triCount; ++t)
+        if (keep[t]) triangles[n++] = triangles[t];
+    triangles.resize(n);
+
+    // Cada banda de filas es de un solo job: sin escrituras compartidas
+    const int bands = (Height + BandHeight - 1) / BandHeight;
+    jobs.ParallelFor(bands, 1, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t b = begin; b < end; ++b)
+        {
+            const int y0 = static_cast<int>(b) * BandHeight;
+            RasterizeBand(y0, std::min(Height, y0 + BandHeight));
+        }
+    });
+}
+
+void OcclusionCuller::RasterizeBand(int y0, int y1)
+{
+    std::fill(depth.begin() + y0 * Width, depth.begin() + y1 * Width, 1.0f);
+
+    for (const ScreenTriangle& t : triangles)
+    {
+        if (t.maxY < y0 || t.minY >= y1) continue;
+
+        const int minX = std::max(0, static_cast<int>(std::floor(std::min({ t.x[0], t.x[1], t.x[2] }))));
+        const int maxX = std::min(Width - 1, static_cast<int>(std::ceil(std::max({ t.x[0], t.x[1], t.x[2] }))));
+        if (minX > maxX) continue;
+        const int rowStart = std::max(y0, t.minY);
+        const int rowEnd = std::min(y1 - 1, t.maxY);
+
+        // Funciones de arista E_i(x, y) = a_i x + b_i y + c_i (>= 0 dentro) y plano de profundidad
+        float a[3], b[3], c[3];
+        for (int e = 0; e < 3; ++e)
+        {
+            const int i = (e + 1) % 3, j = (e + 2) % 3;
+            a[e] = t.y[i] - t.y[j];
+            b[e] = t.x[j] - t.x[i];
+            c[e] = t.x[i] * t.y[j] - t.x[j] * t.y[i];
+        }
+        const float area = c[0] + c[1] + c[2];
+        const float invArea = 1.0f / area;
+        // z = z0 * l0 + z1 * l1 + z2 * l2 con l_e = E_e / area
+        const float dzdx = (a[0] * t.z[0] + a[1] * t.z[1] + a[2] * t.z[2]) * invArea;
+        const float dzdy = (b[0] * t.z[0] + b[1] * t.z[1] + b[2] * t.z[2]) * invArea;
+        const float z00 = (c[0] * t.z[0] + c[1] * t.z[1] + c[2] * t.z[2]) * invArea;
+
+        for (int y = rowStart; y <= rowEnd; ++y)
+        {
+            const float py = y + 0.5f;
+            float* row = &depth[y * Width];
+            int x = minX;
+
+#ifdef OCCLUSION_SSE
+            const __m128 lane = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            for (; x + 3 <= maxX; x += 4)
+            {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane);
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int e = 0; e < 3; ++e)
+                {
+                    const __m128 E = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[e]), px), _mm_set1_ps(b[e] * py + c[e]));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(E, _mm_setzero_ps()));
+                }
+                if (_mm_movemask_ps(inside) == 0) continue;
+
+                const __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), px), _mm_set1_ps(dzdy * py + z00));
+                const __m128 old = _mm_loadu_ps(row + x);
+                const __m128 nearer = _mm_min_ps(old, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+            }
+#endif
+            for (; x <= maxX; ++x)
+            {
+                const float px = x + 0.5f;
+                if (a[0] * px + b[0] * py + c[0] < 0.0f) continue;
+                if (a[1] * px + b[1] * py + c[1] < 0.0f) continue;
+                if (a[2] * px + b[2] * py + c[2] < 0.0f) continue;
+                const float z = dzdx * px + dzdy * py + z00;
+                if (z < row[x]) row[x] = z;
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::IsVisible(const AABB& box) const
+{
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, nearest = 1.0f;
+    int behind = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        const Vec4 h = viewProj.Multiply(Vec4((i & 1) ? box.max.x : box.min.x,
+                                              (i & 2) ? box.max.y : box.min.y,
+                                              (i & 4) ? box.max.z : box.min.z, 1.0));
+        if (h.w <= NEAR_W) { ++behind; continue; }
+        const double invW = 1.0 / h.w;
+        const float x = static_cast<float>((h.x * invW * 0.5 + 0.5) * Width);
+        const float y = static_cast<float>((h.y * invW * 0.5 + 0.5) * Height);
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+        nearest = std::min(nearest, static_cast<float>(h.z * invW * 0.5 + 0.5));
+    }
+
+    if (behind == 8) return false;
+    if (behind > 0) return true;
+    if (maxX < 0.0f || maxY < 0.0f || minX >= Width || minY >= Height) return false;
+    if (nearest < 0.0f) return true;
+
+    const int x0 = std::max(0, static_cast<int>(minX)), x1 = std::min(Width - 1, static_cast<int>(maxX));
+    const int y0 = std::max(0, static_cast<int>(minY)), y1 = std::min(Height - 1, static_cast<int>(maxY));
+
+    for (int y = y0; y <= y1; ++y)
+    {
+        const float* row = &depth[y * Width];
+        int x = x0;
+#ifdef OCCLUSION_SSE
+        const __m128 zn = _mm_set1_ps(nearest);
+        for (; x + 3 <= x1; x += 4)
+            if (_mm_movemask_ps(_mm_cmple_ps(zn, _mm_loadu_ps(row + x))) != 0) return true;
+#endif
+        for (; x <= x1; ++x)
+            if (nearest <= row[x]) return true;
+    }
+    return false;
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Quat.hpp"
 #include <stdexcept>
+#include <cassert>
+#include <algorithm>
 
 #define TOL 1e-6
 #define PI 3.14159265358979323846
@@ -21,32 +23,20 @@ Quat Quat::Normalized() const
     return { s / n, x / n, y / n, z / n };
 }
 
-Quat Quat::Multiply(const Quat& b) const
+bool Quat::IsUnit(double tol) const
 {
-    const Quat& a = *this;
-    Quat q;
-    q.s = a.s * b.s - a.x * b.x - a.y * b.y - a.z * b.z;
-    q.x = a.s * b.x + a.x * b.s + a.y * b.z - a.z * b.y;
-    q.y = a.s * b.y - a.x * b.z + a.y * b.s + a.z * b.x;
-    q.z = a.s * b.z + a.x * b.y - a.y * b.x + a.z * b.s;
-    return q;
+    return std::fabs(s * s + x * x + y * y + z * z - 1.0) < tol;
 }
 
-Vec3 Quat::Rotate(const Vec3& v) const
+Matrix3x3 Quat::ToMatrix3x3() const
 {
-    Vec3 qv{ x, y, z };
-    Vec3 t = Vec3::Cross(qv, v);
-    t.x *= 2.0; t.y *= 2.0; t.z *= 2.0;
-    Vec3 st{ s * t.x, s * t.y, s * t.z };
-    Vec3 cqt = Vec3::Cross(qv, t);
-    Vec3 w{ v.x + st.x + cqt.x, v.y + st.y + cqt.y, v.z + st.z + cqt.z };
-    return w;
+    return Normalized().ToMatrix3x3Unchecked();
 }
 
-Matrix3x3 Quat::ToMatrix3x3() const
+Matrix3x3 Quat::ToMatrix3x3Unchecked() const
 {
-    Quat q = this->Normalized();
-    const double ww = q.s, xx = q.x, yy = q.y, zz = q.z;
+    assert(IsUnit() && "Quat::ToMatrix3x3Unchecked: quaternion not normalized");
+    const double ww = s, xx = x, yy = y, zz = z;
 
     Matrix3x3 R{};
     const double xx2 = xx * xx, yy2 = yy * yy, zz2 = zz * zz;
@@ -71,6 +61,13 @@ Quat Quat::FromMatrix3x3(const Matrix3x3& R)
 {
     if (!R.IsRotation()) throw std::invalid_argument("FromMatrix3x3: input not rotation");
 
+    return FromMatrix3x3Unchecked(R).Normalized();
+}
+
+Quat Quat::FromMatrix3x3Unchecked(const Matrix3x3& R)
+{
+    assert(R.IsRotation() && "Quat::FromMatrix3x3Unchecked: input not rotation");
+
     Quat q;
     double tr = R.At(0, 0) + R.At(1, 1) + R.At(2, 2);
 
@@ -107,7 +104,7 @@ Quat Quat::FromMatrix3x3(const Matrix3x3& R)
         q.z = 0.25 * S;
     }
 
-    return q.Normalized();
+    return q;
 }
 
 void Quat::ToAxisAngle(Vec3& axis, double& angle) const
@@ -164,12 +161,59 @@ Quat Quat::RotateToTarget(const Quat& initialRot, const Quat& finalRot)
 
 Quat Quat::FromEulerZYX(double yaw, double pitch, double roll)
 {
-    Matrix3x3 R = Matrix3x3::FromEulerZYX(yaw, pitch, roll);
-    return FromMatrix3x3(R);
+    const double cy = std::cos(yaw * 0.5), sy = std::sin(yaw * 0.5);
+    const double cp = std::cos(pitch * 0.5), sp = std::sin(pitch * 0.5);
+    const double cr = std::cos(roll * 0.5), sr = std::sin(roll * 0.5);
+
+    Quat q;
+    q.s = cr * cp * cy + sr * sp * sy;
+    q.x = sr * cp * cy - cr * sp * sy;
+    q.y = cr * sp * cy + sr * cp * sy;
+    q.z = cr * cp * sy - sr * sp * cy;
+    return q;
 }
 
 void Quat::ToEulerZYX(double& yaw, double& pitch, double& roll) const
 {
-    Matrix3x3 R = ToMatrix3x3();
-    R.ToEulerZYX(yaw, pitch, roll);
+    // Mismos terminos que Matrix3x3::ToEulerZYX, pero solo los elementos de R que hacen falta
+    const Quat q = Normalized();
+    const double r20 = 2.0 * (q.x * q.z - q.s * q.y);
+
+    if (std::fabs(r20) < 1.0 - TOL)
+    {
+        pitch = std::asin(-r20);
+        yaw = std::atan2(2.0 * (q.x * q.y + q.s * q.z), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+        roll = std::atan2(2.0 * (q.y * q.z + q.s * q.x), 1.0 - 2.0 * (q.x * q.x + q.y * q.y));
+    }
+    else
+    {
+        pitch = (r20 < 0.0) ? +PI / 2 : -PI / 2;
+        yaw = std::atan2(-2.0 * (q.x * q.y - q.s * q.z), 1.0 - 2.0 * (q.x * q.x + q.z * q.z));
+        roll = 0.0;
+    }
+}
+
+
+Quat Quat::Slerp(const Quat& a, const Quat& b, double t)
+{
+    double d = a.s * b.s + a.x * b.x + a.y * b.y + a.z * b.z;
+    Quat to = b;
+    if (d < 0.0)
+    {
+        // q y -q son la misma rotacion: se va por el lado corto
+        d = -d;
+        to = { -b.s, -b.x, -b.y, -b.z };
+    }
+
+    double wa = 1.0 - t, wb = t;
+    if (d < 1.0 - TOL)
+    {
+        const double theta = std::acos(d);
+        const double inv = 1.0 / std::sin(theta);
+        wa = std::sin((1.0 - t) * theta) * inv;
+        wb = std::sin(t * theta) * inv;
+    }
+
+    const Quat q{ wa * a.s + wb * to.s, wa * a.x + wb * to.x, wa * a.y + wb * to.y, wa * a.z + wb * to.z };
+    return d < 1.0 - TOL ? q : q.Normalized();
 }
\ No newline at end of file
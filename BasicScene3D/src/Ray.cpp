@@ -0,0 +1,80 @@
+#include "Ray.hpp"
+#include <cmath>
+#include <algorithm>
+
+void AABB::Expand(const Vec3& p)
+{
+    min.x = std::min(min.x, p.x); min.y = std::min(min.y, p.y); min.z = std::min(min.z, p.z);
+    max.x = std::max(max.x, p.x); max.y = std::max(max.y, p.y); max.z = std::max(max.z, p.z);
+}
+
+void AABB::Expand(const AABB& b)
+{
+    if (b.IsEmpty()) return;
+    Expand(b.min);
+    Expand(b.max);
+}
+
+Vec3 AABB::Center() const
+{
+    return { (min.x + max.x) * 0.5, (min.y + max.y) * 0.5, (min.z + max.z) * 0.5 };
+}
+
+double AABB::SurfaceArea() const
+{
+    if (IsEmpty()) return 0.0;
+    const double dx = max.x - min.x, dy = max.y - min.y, dz = max.z - min.z;
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
+AABB AABB::FromOBB(const Affine3& M, const Vec3& h)
+{
+    // Extents mundo = |RS| * h (Arvo)
+    const Vec3 c = M.Translation();
+    Vec3 e;
+    e.x = std::fabs(M.At(0, 0)) * h.x + std::fabs(M.At(0, 1)) * h.y + std::fabs(M.At(0, 2)) * h.z;
+    e.y = std::fabs(M.At(1, 0)) * h.x + std::fabs(M.At(1, 1)) * h.y + std::fabs(M.At(1, 2)) * h.z;
+    e.z = std::fabs(M.At(2, 0)) * h.x + std::fabs(M.At(2, 1)) * h.y + std::fabs(M.At(2, 2)) * h.z;
+
+    AABB b;
+    b.min = { c.x - e.x, c.y - e.y, c.z - e.z };
+    b.max = { c.x + e.x, c.y + e.y, c.z + e.z };
+    return b;
+}
+
+Vec3 Ray::At(double t) const
+{
+    return { origin.x + direction.x * t, origin.y + direction.y * t, origin.z + direction.z * t };
+}
+
+bool Ray::IntersectAABB(const Vec3& o, const Vec3& invDir, const AABB& box, double tMax, double& tHit)
+{
+    double t0 = (box.min.x - o.x) * invDir.x, t1 = (box.max.x - o.x) * invDir.x;
+    double tmin = std::min(t0, t1), tmax = std::max(t0, t1);
+
+    t0 = (box.min.y - o.y) * invDir.y; t1 = (box.max.y - o.y) * invDir.y;
+    tmin = std::max(tmin, std::min(t0, t1)); tmax = std::min(tmax, std::max(t0, t1));
+
+    t0 = (box.min.z - o.z) * invDir.z; t1 = (box.max.z - o.z) * invDir.z;
+    tmin = std::max(tmin, std::min(t0, t1)); tmax = std::min(tmax, std::max(t0, t1));
+
+    tmin = std::max(tmin, 0.0);
+    if (tmax < tmin || tmin > tMax) return false;
+
+    tHit = tmin;
+    return true;
+}
+
+bool Ray::IntersectOBB(const Ray& ray, const Affine3& invWorld, const Vec3& h, double& tHit)
+{
+    // En espacio local la OBB es un AABB; t no cambia porque la direccion no se normaliza
+    Vec3 o = invWorld.TransformPoint(ray.origin);
+    Vec3 d = invWorld.TransformVector(ray.direction);
+
+    Vec3 invDir{ 1.0 / d.x, 1.0 / d.y, 1.0 / d.z };
+    AABB box;
+    box.min = { -h.x, -h.y, -h.z };
+    box.max = h;
+
+    return IntersectAABB(o, invDir, box, 1e300, tHit);
+}
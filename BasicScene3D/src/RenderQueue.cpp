@@ -0,0 +1,57 @@
+#include "RenderQueue.hpp"
+#include <algorithm>
+#include <cstring>
+
+uint64_t RenderQueue::MakeKey(RenderPass pass, uint32_t program, uint32_t mesh, uint32_t material, uint32_t depth)
+{
+    const uint32_t depthMask = (1u << DepthBits) - 1;
+    depth &= depthMask;
+    if (pass == RenderPass::Transparent) depth = depthMask - depth;
+
+    return (uint64_t(static_cast<uint8_t>(pass)) & 0xF) << 60 |
+           (uint64_t(program) & 0xFFF) << 48 |
+           (uint64_t(mesh) & 0xFFF) << 36 |
+           (uint64_t(material) & 0xFFF) << 24 |
+           uint64_t(depth);
+}
+
+uint32_t RenderQueue::QuantizeDepth(double viewDepth, double nearPlane, double farPlane)
+{
+    const double range = farPlane - nearPlane;
+    double d = range > 0.0 ? (viewDepth - nearPlane) / range : 0.0;
+    d = std::clamp(d, 0.0, 1.0);
+    return static_cast<uint32_t>(d * double((1u << DepthBits) - 1));
+}
+
+void RenderQueue::Sort()
+{
+    const std::size_t n = items.size();
+    if (n < 2) return;
+
+    // Histogramas de los 8 bytes en una sola pasada
+    std::size_t counts[8][256];
+    std::memset(counts, 0, sizeof(counts));
+    for (const RenderItem& it : items)
+        for (int b = 0; b < 8; ++b)
+            ++counts[b][(it.key >> (b * 8)) & 0xFF];
+
+    scratch.resize(n);
+    for (int b = 0; b < 8; ++b)
+    {
+        const std::size_t* c = counts[b];
+        const unsigned first = static_cast<unsigned>((items[0].key >> (b * 8)) & 0xFF);
+        if (c[first] == n) continue;
+
+        std::size_t offsets[256];
+        std::size_t sum = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            offsets[i] = sum;
+            sum += c[i];
+        }
+
+        for (const RenderItem& it : items)
+            scratch[offsets[(it.key >> (b * 8)) & 0xFF]++] = it;
+        items.swap(scratch);
+    }
+}
\ No newline at end of file
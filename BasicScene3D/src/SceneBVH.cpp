@@ -0,0 +1,231 @@
+#include "SceneBVH.hpp"
+#include <algorithm>
+#include <cmath>
+
+#define BVH_BINS 16
+#define BVH_LEAF_SIZE 4
+// Raycast recorre con una pila fija: cada nivel deja como mucho un hermano apilado, asi que con esta
+// profundidad maxima la pila nunca pasa de BVH_MAX_DEPTH + 1 entradas
+#define BVH_MAX_DEPTH 64
+#define BVH_STACK_SIZE (BVH_MAX_DEPTH + 2)
+
+void SceneBVH::Gather(GameObject* node, const Affine3& parentWorld, const std::function<Vec3(uint32_t)>& halfExtentsOf)
+{
+    // Globales acumuladas en el recorrido: O(n) en vez de GetGlobalMatrix por nodo
+    Affine3 world = parentWorld.Multiply(node->transform.GetLocalMatrix());
+
+    Primitive p;
+    p.object = node;
+    p.halfExtents = halfExtentsOf(node->mesh);
+    p.bounds = AABB::FromOBB(world, p.halfExtents);
+    p.centroid = p.bounds.Center();
+    // Escala 0: no se puede seleccionar, pero sus hijos si
+    if (std::fabs(world.Det()) >= 1e-12)
+    {
+        p.invWorld = world.Inverse();
+        prims.push_back(p);
+    }
+
+    for (GameObject* child : node->children)
+        Gather(child, world, halfExtentsOf);
+}
+
+void SceneBVH::Build(const std::vector<GameObject*>& roots, const std::function<Vec3(uint32_t)>& halfExtentsOf)
+{
+    prims.clear();
+    nodes.clear();
+
+    for (GameObject* root : roots)
+        if (root) Gather(root, Affine3::Identity(), halfExtentsOf);
+
+    if (prims.empty()) return;
+
+    nodes.reserve(2 * prims.size());
+    Node root;
+    root.first = 0;
+    root.count = (uint32_t)prims.size();
+    nodes.push_back(root);
+    Subdivide(0, 0);
+}
+
+void SceneBVH::Refit()
+{
+    for (Primitive& p : prims)
+    {
+        const Affine3& world = p.object->GetGlobalMatrix();
+        // Escala 0 despues de construir: caja vacia, el rayo no la toca
+        if (std::fabs(world.Det()) < 1e-12)
+        {
+            p.bounds = AABB();
+            continue;
+        }
+        p.invWorld = world.Inverse();
+        p.bounds = AABB::FromOBB(world, p.halfExtents);
+    }
+
+    // Los hijos siempre tienen indice mayor que el padre: de atras adelante los hijos ya estan
+    for (std::size_t i = nodes.size(); i-- > 0;)
+    {
+        Node& node = nodes[i];
+        node.bounds = AABB();
+        if (node.count > 0)
+        {
+            for (uint32_t j = node.first; j < node.first + node.count; ++j)
+                node.bounds.Expand(prims[j].bounds);
+        }
+        else
+        {
+            node.bounds.Expand(nodes[node.first].bounds);
+            node.bounds.Expand(nodes[node.first + 1].bounds);
+        }
+    }
+}
+
+void SceneBVH::Subdivide(uint32_t nodeIndex, int depth)
+{
+    Node& node = nodes[nodeIndex];
+
+    AABB centroidBounds;
+    for (uint32_t i = node.first; i < node.first + node.count; ++i)
+    {
+        node.bounds.Expand(prims[i].bounds);
+        centroidBounds.Expand(prims[i].centroid);
+    }
+
+    // Arbol degenerado (p.ej. miles de centroides casi iguales): a partir de aqui hojas grandes
+    if (node.count <= BVH_LEAF_SIZE || depth >= BVH_MAX_DEPTH) return;
+
+    // Binned SAH sobre el eje mas largo de los centroides
+    Vec3 ext{ centroidBounds.max.x - centroidBounds.min.x, centroidBounds.max.y - centroidBounds.min.y, centroidBounds.max.z - centroidBounds.min.z };
+    int axis = 0;
+    if (ext.y > ext.x) axis = 1;
+    if (ext.z > (axis == 0 ? ext.x : ext.y)) axis = 2;
+
+    auto comp = [axis](const Vec3& v) { return axis == 0 ? v.x : (axis == 1 ? v.y : v.z); };
+    const double cmin = comp(centroidBounds.min);
+    const double cext = comp(ext);
+    if (cext <= 0.0) return; // todos los centroides coinciden
+
+    struct Bin { AABB bounds; uint32_t count = 0; };
+    Bin bins[BVH_BINS];
+    const double scale = BVH_BINS / cext;
+    auto binOf = [&](const Primitive& p) {
+        int b = (int)((comp(p.centroid) - cmin) * scale);
+        return std::min(b, BVH_BINS - 1);
+    };
+
+    for (uint32_t i = node.first; i < node.first + node.count; ++i)
+    {
+        Bin& b = bins[binOf(prims[i])];
+        b.bounds.Expand(prims[i].bounds);
+        b.count++;
+    }
+
+    double leftArea[BVH_BINS - 1], rightArea[BVH_BINS - 1];
+    uint32_t leftCount[BVH_BINS - 1], rightCount[BVH_BINS - 1];
+    AABB leftBox, rightBox;
+    uint32_t leftSum = 0, rightSum = 0;
+    for (int i = 0; i < BVH_BINS - 1; ++i)
+    {
+        leftSum += bins[i].count;
+        leftCount[i] = leftSum;
+        leftBox.Expand(bins[i].bounds);
+        leftArea[i] = leftBox.SurfaceArea();
+
+        rightSum += bins[BVH_BINS - 1 - i].count;
+        rightCount[BVH_BINS - 2 - i] = rightSum;
+        rightBox.Expand(bins[BVH_BINS - 1 - i].bounds);
+        rightArea[BVH_BINS - 2 - i] = rightBox.SurfaceArea();
+    }
+
+    int bestSplit = -1;
+    double bestCost = node.bounds.SurfaceArea() * node.count;
+    for (int i = 0; i < BVH_BINS - 1; ++i)
+    {
+        if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+        double cost = leftArea[i] * leftCount[i] + rightArea[i] * rightCount[i];
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestSplit = i;
+        }
+    }
+    if (bestSplit < 0) return;
+
+    auto mid = std::partition(prims.begin() + node.first, prims.begin() + node.first + node.count,
+        [&](const Primitive& p) { return binOf(p) <= bestSplit; });
+    uint32_t leftN = (uint32_t)(mid - (prims.begin() + node.first));
+
+    Node left, right;
+    left.first = node.first;
+    left.count = leftN;
+    right.first = node.first + leftN;
+    right.count = node.count - leftN;
+
+    uint32_t leftIndex = (uint32_t)nodes.size();
+    node.first = leftIndex;
+    node.count = 0;
+    // push_back puede invalidar 'node'; ya no se usa a partir de aqui
+    nodes.push_back(left);
+    nodes.push_back(right);
+
+    Subdivide(leftIndex, depth + 1);
+    Subdivide(leftIndex + 1, depth + 1);
+}
+
+bool SceneBVH::Raycast(const Ray& ray, RayHit& hit) const
+{
+    if (nodes.empty()) return false;
+
+    const Vec3 invDir{ 1.0 / ray.direction.x, 1.0 / ray.direction.y, 1.0 / ray.direction.z };
+
+    struct Entry { uint32_t node; double t; };
+    Entry stack[BVH_STACK_SIZE];
+    int sp = 0;
+
+    double tNode;
+    if (!Ray::IntersectAABB(ray.origin, invDir, nodes[0].bounds, hit.t, tNode)) return false;
+    stack[sp++] = { 0, tNode };
+
+    bool found = false;
+    while (sp > 0)
+    {
+        const Entry e = stack[--sp];
+        if (e.t > hit.t) continue; // el hit actual esta antes que este nodo
+        const Node& node = nodes[e.node];
+
+        if (node.count > 0)
+        {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const Primitive& p = prims[i];
+                double tBox, t;
+                if (!Ray::IntersectAABB(ray.origin, invDir, p.bounds, hit.t, tBox)) continue;
+                if (Ray::IntersectOBB(ray, p.invWorld, p.halfExtents, t) && t < hit.t)
+                {
+                    hit.t = t;
+                    hit.object = p.object;
+                    found = true;
+                }
+            }
+            continue;
+        }
+
+        // Primero el hijo mas cercano; el lejano se descarta si ya hay un hit antes
+        uint32_t a = node.first, b = node.first + 1;
+        double ta, tb;
+        bool hitA = Ray::IntersectAABB(ray.origin, invDir, nodes[a].bounds, hit.t, ta);
+        bool hitB = Ray::IntersectAABB(ray.origin, invDir, nodes[b].bounds, hit.t, tb);
+
+        if (hitA && hitB)
+        {
+            if (ta > tb) { std::swap(a, b); std::swap(ta, tb); }
+            stack[sp++] = { b, tb };
+            stack[sp++] = { a, ta };
+        }
+        else if (hitA) stack[sp++] = { a, ta };
+        else if (hitB) stack[sp++] = { b, tb };
+    }
+
+    return found;
+}
@@ -0,0 +1,94 @@
+#include "Selection.hpp"
+#include "CommandJournal.hpp"
+#include <algorithm>
+
+void Selection::Clear()
+{
+    items.clear();
+    lookup.clear();
+    rootsDirty = true;
+}
+
+void Selection::Set(GameObject* obj)
+{
+    Clear();
+    Add(obj);
+}
+
+void Selection::Add(GameObject* obj)
+{
+    if (!obj || !lookup.insert(obj).second) return;
+    items.push_back(obj);
+    rootsDirty = true;
+}
+
+void Selection::Remove(GameObject* obj)
+{
+    if (!lookup.erase(obj)) return;
+    items.erase(std::find(items.begin(), items.end(), obj));
+    rootsDirty = true;
+}
+
+void Selection::Toggle(GameObject* obj)
+{
+    if (Contains(obj)) Remove(obj);
+    else Add(obj);
+}
+
+const std::vector<GameObject*>& Selection::SubtreeRoots() const
+{
+    if (!rootsDirty) return roots;
+
+    roots.clear();
+    for (GameObject* obj : items)
+    {
+        bool covered = false;
+        for (GameObject* p = obj->parent; p && !covered; p = p->parent)
+            covered = lookup.count(p) != 0;
+        if (!covered) roots.push_back(obj);
+    }
+
+    rootsDirty = false;
+    return roots;
+}
+
+void Selection::Translate(const Vec3& delta, CommandJournal* journal)
+{
+    if (journal) journal->BeginTick(TransformField::Position);
+
+    for (GameObject* obj : SubtreeRoots())
+    {
+        Vec3& p = obj->transform.position;
+        const Vec3 old = p;
+        p.x += delta.x; p.y += delta.y; p.z += delta.z;
+        obj->MarkWorldDirty();
+        if (journal) journal->Record(obj, old, p);
+    }
+}
+
+void Selection::RotateEuler(const Vec3& delta, CommandJournal* journal)
+{
+    if (journal) journal->BeginTick(TransformField::Rotation);
+
+    for (GameObject* obj : SubtreeRoots())
+    {
+        const Vec3 old = obj->transform.eulerRotation;
+        obj->transform.SetEulerRotation({ old.x + delta.x, old.y + delta.y, old.z + delta.z });
+        obj->MarkWorldDirty();
+        if (journal) journal->Record(obj, old, obj->transform.eulerRotation);
+    }
+}
+
+void Selection::AddScale(const Vec3& delta, CommandJournal* journal)
+{
+    if (journal) journal->BeginTick(TransformField::Scale);
+
+    for (GameObject* obj : SubtreeRoots())
+    {
+        Vec3& s = obj->transform.scale;
+        const Vec3 old = s;
+        s.x += delta.x; s.y += delta.y; s.z += delta.z;
+        obj->MarkWorldDirty();
+        if (journal) journal->Record(obj, old, s);
+    }
+}
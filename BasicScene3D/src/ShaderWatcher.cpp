@@ -0,0 +1,72 @@
+#include "ShaderWatcher.hpp"
+#include <algorithm>
+
+namespace {
+    std::filesystem::file_time_type ModifiedTime(const std::string& path)
+    {
+        // Un fichero a medio guardar puede no existir un momento: se trata como sin fecha
+        std::error_code ec;
+        const auto time = std::filesystem::last_write_time(path, ec);
+        return ec ? std::filesystem::file_time_type::min() : time;
+    }
+}
+
+ShaderWatcher::ShaderWatcher(std::chrono::milliseconds interval)
+    : interval(interval)
+{
+    thread = std::thread(&ShaderWatcher::PollLoop, this);
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void ShaderWatcher::Watch(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Entry& e : entries)
+        if (e.path == path) return;
+    entries.push_back({ path, ModifiedTime(path) });
+}
+
+std::vector<std::string> ShaderWatcher::TakeChanged()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> result;
+    result.swap(changed);
+    return result;
+}
+
+void ShaderWatcher::PollLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, interval, [this] { return stopping; }))
+    {
+        // Copia para no tener el lock durante las llamadas al sistema de ficheros
+        std::vector<Entry> snapshot = entries;
+        lock.unlock();
+
+        std::vector<Entry> modified;
+        for (const Entry& e : snapshot)
+        {
+            const auto time = ModifiedTime(e.path);
+            if (time != e.time && time != std::filesystem::file_time_type::min())
+                modified.push_back({ e.path, time });
+        }
+
+        lock.lock();
+        for (const Entry& m : modified)
+        {
+            for (Entry& e : entries)
+                if (e.path == m.path) e.time = m.time;
+            if (std::find(changed.begin(), changed.end(), m.path) == changed.end())
+                changed.push_back(m.path);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "Skeleton.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKINNING_SSE 1
+#include <xmmintrin.h>
+#endif
+
+int Skeleton::AddJoint(GameObject* joint)
+{
+    if (!joint) throw std::invalid_argument("Skeleton::AddJoint: null joint");
+    if (joints.size() >= MaxJoints) throw std::runtime_error("Skeleton::AddJoint: too many joints");
+
+    int parent = -1;
+    for (std::size_t i = 0; i < joints.size(); ++i)
+    {
+        if (joints[i] == joint->parent)
+        {
+            parent = static_cast<int>(i);
+            break;
+        }
+    }
+
+    joints.push_back(joint);
+    parentIndex.push_back(parent);
+    inverseBind.push_back(Affine3::Identity());
+    inverseBindDQ.push_back(DualQuat::Identity());
+    return static_cast<int>(joints.size() - 1);
+}
+
+void Skeleton::Bind()
+{
+    for (std::size_t i = 0; i < joints.size(); ++i)
+    {
+        inverseBind[i] = joints[i]->GetGlobalMatrix().Inverse();
+        inverseBindDQ[i] = joints[i]->GetGlobalDualQuat().Inverse();
+    }
+}
+
+void Skeleton::ComputePalette(std::vector<float>& palette, const Vec3& origin) const
+{
+    const std::size_t n = joints.size();
+    globals.resize(n);
+    palette.resize(n * 12);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        // Como los padres van antes, la global del padre ya esta calculada
+        const int p = parentIndex[i];
+        if (p >= 0)
+            globals[i] = globals[p].Multiply(joints[i]->transform.GetLocalMatrix());
+        else
+            globals[i] = joints[i]->GetGlobalMatrix();
+
+        Affine3 world = globals[i].Multiply(inverseBind[i]);
+        world.At(0, 3) -= origin.x;
+        world.At(1, 3) -= origin.y;
+        world.At(2, 3) -= origin.z;
+        const Affine3f skin(world);
+        std::copy(skin.m, skin.m + 12, &palette[i * 12]);
+    }
+}
+
+void Skeleton::ComputeDualQuatPalette(std::vector<float>& palette, const Vec3& origin) const
+{
+    const std::size_t n = joints.size();
+    globalsDQ.resize(n);
+    palette.resize(n * 8);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const int p = parentIndex[i];
+        if (p >= 0)
+            globalsDQ[i] = globalsDQ[p].Multiply(DualQuat::FromTransform(joints[i]->transform));
+        else
+            globalsDQ[i] = joints[i]->GetGlobalDualQuat();
+
+        const DualQuat skin = DualQuat::FromRotationTranslation(Quat(), { -origin.x, -origin.y, -origin.z })
+                                  .Multiply(globalsDQ[i].Multiply(inverseBindDQ[i]));
+
+        float* dst = &palette[i * 8];
+        dst[0] = (float)skin.real.x; dst[1] = (float)skin.real.y; dst[2] = (float)skin.real.z; dst[3] = (float)skin.real.s;
+        dst[4] = (float)skin.dual.x; dst[5] = (float)skin.dual.y; dst[6] = (float)skin.dual.z; dst[7] = (float)skin.dual.s;
+    }
+}
+
+namespace Skinning {
+
+    void SkinVerticesScalar(const SkinVertex* in, std::size_t count, const float* palette, float* out)
+    {
+        for (std::size_t v = 0; v < count; ++v)
+        {
+            const SkinVertex& sv = in[v];
+
+            float m[12] = { 0 };
+            for (int j = 0; j < 4; ++j)
+            {
+                const float w = sv.weights[j];
+                if (w == 0.0f) continue;
+                const float* P = palette + sv.joints[j] * 12;
+                for (int k = 0; k < 12; ++k) m[k] += w * P[k];
+            }
+
+            const float* p = sv.position;
+            const float* n = sv.normal;
+            float* o = out + v * 6;
+
+            o[0] = m[0] * p[0] + m[1] * p[1] + m[2] * p[2] + m[3];
+            o[1] = m[4] * p[0] + m[5] * p[1] + m[6] * p[2] + m[7];
+            o[2] = m[8] * p[0] + m[9] * p[1] + m[10] * p[2] + m[11];
+
+            float nx = m[0] * n[0] + m[1] * n[1] + m[2] * n[2];
+            float ny = m[4] * n[0] + m[5] * n[1] + m[6] * n[2];
+            float nz = m[8] * n[0] + m[9] * n[1] + m[10] * n[2];
+            float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+            float inv = len > 0.0f ? 1.0f / len : 0.0f;
+            o[3] = nx * inv;
+            o[4] = ny * inv;
+            o[5] = nz * inv;
+        }
+    }
+
+    void SkinVerticesDualQuat(const SkinVertex* in, std::size_t count, const float* palette, float* out)
+    {
+        for (std::size_t v = 0; v < count; ++v)
+        {
+            const SkinVertex& sv = in[v];
+
+            // Mezcla en el mismo hemisferio que el primer joint (q y -q son la misma rotacion)
+            const float* Q0 = palette + sv.joints[0] * 8;
+            float b[8] = { 0 };
+            for (int j = 0; j < 4; ++j)
+            {
+                float w = sv.weights[j];
+                if (w == 0.0f) continue;
+                const float* Q = palette + sv.joints[j] * 8;
+                if (Q[0] * Q0[0] + Q[1] * Q0[1] + Q[2] * Q0[2] + Q[3] * Q0[3] < 0.0f) w = -w;
+                for (int k = 0; k < 8; ++k) b[k] += w * Q[k];
+            }
+
+            const float len = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+            const float inv = len > 0.0f ? 1.0f / len : 0.0f;
+            for (int k = 0; k < 8; ++k) b[k] *= inv;
+
+            // r = (rx, ry, rz, rw), d = (dx, dy, dz, dw); t = 2 * (rw * d.xyz - dw * r.xyz + r.xyz x d.xyz)
+            const float rx = b[0], ry = b[1], rz = b[2], rw = b[3];
+            const float dx = b[4], dy = b[5], dz = b[6], dw = b[7];
+            const float tx = 2.0f * (rw * dx - dw * rx + ry * dz - rz * dy);
+            const float ty = 2.0f * (rw * dy - dw * ry + rz * dx - rx * dz);
+            const float tz = 2.0f * (rw * dz - dw * rz + rx * dy - ry * dx);
+
+            const float* src[2] = { sv.position, sv.normal };
+            float* o = out + v * 6;
+            for (int a = 0; a < 2; ++a)
+            {
+                // v' = v + 2 r.xyz x (r.xyz x v + rw v)
+                const float* p = src[a];
+                const float cx = ry * p[2] - rz * p[1] + rw * p[0];
+                const float cy = rz * p[0] - rx * p[2] + rw * p[1];
+                const float cz = rx * p[1] - ry * p[0] + rw * p[2];
+                o[a * 3 + 0] = p[0] + 2.0f * (ry * cz - rz * cy);
+                o[a * 3 + 1] = p[1] + 2.0f * (rz * cx - rx * cz);
+                o[a * 3 + 2] = p[2] + 2.0f * (rx * cy - ry * cx);
+            }
+            o[0] += tx; o[1] += ty; o[2] += tz;
+        }
+    }
+
+#ifdef SKINNING_SSE
+    void SkinVertices(const SkinVertex* in, std::size_t count, const float* palette, float* out)
+    {
+        for (std::size_t v = 0; v < count; ++v)
+        {
+            const SkinVertex& sv = in[v];
+
+            // Mezcla de las 3 filas de la paleta con los pesos
+            __m128 r0 = _mm_setzero_ps();
+            __m128 r1 = _mm_setzero_ps();
+            __m128 r2 = _mm_setzero_ps();
+            for (int j = 0; j < 4; ++j)
+            {
+                const __m128 w = _mm_set1_ps(sv.weights[j]);
+                const float* P = palette + sv.joints[j] * 12;
+                r0 = _mm_add_ps(r0, _mm_mul_ps(w, _mm_loadu_ps(P)));
+                r1 = _mm_add_ps(r1, _mm_mul_ps(w, _mm_loadu_ps(P + 4)));
+                r2 = _mm_add_ps(r2, _mm_mul_ps(w, _mm_loadu_ps(P + 8)));
+            }
+
+            // Pasamos a columnas para transformar con mul + add
+            __m128 r3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            __m128 pos = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(r0, _mm_set1_ps(sv.position[0])), _mm_mul_ps(r1, _mm_set1_ps(sv.position[1]))),
+                _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(sv.position[2])), r3));
+
+            __m128 nrm = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(r0, _mm_set1_ps(sv.normal[0])), _mm_mul_ps(r1, _mm_set1_ps(sv.normal[1]))),
+                _mm_mul_ps(r2, _mm_set1_ps(sv.normal[2])));
+
+            // Normalizacion: el cuarto carril es 0, no afecta al producto escalar
+            __m128 sq = _mm_mul_ps(nrm, nrm);
+            __m128 sum = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 3, 0, 1)));
+            sum = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+            __m128 len = _mm_sqrt_ps(sum);
+            __m128 mask = _mm_cmpgt_ps(len, _mm_setzero_ps());
+            nrm = _mm_and_ps(_mm_div_ps(nrm, len), mask);
+
+            alignas(16) float p4[4];
+            alignas(16) float n4[4];
+            _mm_store_ps(p4, pos);
+            _mm_store_ps(n4, nrm);
+
+            float* o = out + v * 6;
+            o[0] = p4[0]; o[1] = p4[1]; o[2] = p4[2];
+            o[3] = n4[0]; o[4] = n4[1]; o[5] = n4[2];
+        }
+    }
+#else
+    void SkinVertices(const SkinVertex* in, std::size_t count, const float* palette, float* out)
+    {
+        SkinVerticesScalar(in, count, palette, out);
+    }
+#endif
+}
@@ -0,0 +1,416 @@
+#include "TextureCodec.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // vkFormat de la especificacion de Vulkan (los que se aceptan)
+    enum : uint32_t
+    {
+        VkR8G8B8A8Unorm = 37, VkR8G8B8A8Srgb = 43,
+        VkBc1RgbUnorm = 131, VkBc1RgbSrgb = 132, VkBc1RgbaUnorm = 133, VkBc1RgbaSrgb = 134,
+        VkBc3Unorm = 137, VkBc3Srgb = 138,
+        VkEtc2R8G8B8Unorm = 147, VkEtc2R8G8B8Srgb = 148, VkEtc2R8G8B8A8Unorm = 151, VkEtc2R8G8B8A8Srgb = 152
+    };
+
+    bool FormatFromVk(uint32_t vkFormat, TextureFormat& format)
+    {
+        switch (vkFormat)
+        {
+        case VkR8G8B8A8Unorm: case VkR8G8B8A8Srgb: format = TextureFormat::RGBA8; return true;
+        case VkBc1RgbUnorm: case VkBc1RgbSrgb: format = TextureFormat::BC1_RGB; return true;
+        case VkBc1RgbaUnorm: case VkBc1RgbaSrgb: format = TextureFormat::BC1_RGBA; return true;
+        case VkBc3Unorm: case VkBc3Srgb: format = TextureFormat::BC3; return true;
+        case VkEtc2R8G8B8Unorm: case VkEtc2R8G8B8Srgb: format = TextureFormat::ETC2_RGB8; return true;
+        case VkEtc2R8G8B8A8Unorm: case VkEtc2R8G8B8A8Srgb: format = TextureFormat::ETC2_RGBA8; return true;
+        default: return false;
+        }
+    }
+
+    // KTX2 es little-endian
+    uint32_t ReadU32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+    uint64_t ReadU64(const uint8_t* p) { return ReadU32(p) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32); }
+
+    uint8_t Clamp255(int v) { return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+    // --- BC1 / BC3 (S3TC) ---
+
+    // Bloque de color BC1: dos extremos RGB565 y 2 bits por texel (fila a fila). fourColors: BC3 ignora
+    // el orden de los extremos; en BC1 c0 <= c1 da 3 colores y el indice 3 es negro (transparente en RGBA)
+    void DecodeBc1Color(const uint8_t* block, uint8_t* rgba, bool fourColors, bool punchThrough)
+    {
+        const uint32_t c0 = block[0] | (block[1] << 8);
+        const uint32_t c1 = block[2] | (block[3] << 8);
+        uint8_t palette[4][4];
+        for (int k = 0; k < 2; ++k)
+        {
+            const uint32_t c = k == 0 ? c0 : c1;
+            const uint32_t r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+            palette[k][0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+            palette[k][1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+            palette[k][2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+            palette[k][3] = 255;
+        }
+        for (int ch = 0; ch < 3; ++ch)
+        {
+            if (fourColors || c0 > c1)
+            {
+                palette[2][ch] = static_cast<uint8_t>((2 * palette[0][ch] + palette[1][ch]) / 3);
+                palette[3][ch] = static_cast<uint8_t>((palette[0][ch] + 2 * palette[1][ch]) / 3);
+            }
+            else
+            {
+                palette[2][ch] = static_cast<uint8_t>((palette[0][ch] + palette[1][ch]) / 2);
+                palette[3][ch] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = (fourColors || c0 > c1 || !punchThrough) ? 255 : 0;
+
+        const uint32_t bits = ReadU32(block + 4);
+        for (int i = 0; i < 16; ++i)
+            std::memcpy(rgba + i * 4, palette[(bits >> (i * 2)) & 3], 4);
+    }
+
+    // Alfa de BC3: dos extremos y 3 bits por texel (48 bits, fila a fila)
+    void DecodeBc3Alpha(const uint8_t* block, uint8_t* rgba)
+    {
+        const int a0 = block[0], a1 = block[1];
+        int palette[8] = { a0, a1 };
+        if (a0 > a1)
+        {
+            for (int k = 1; k < 7; ++k) palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+        }
+        else
+        {
+            for (int k = 1; k < 5; ++k) palette[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t bits = 0;
+        for (int k = 0; k < 6; ++k) bits |= static_cast<uint64_t>(block[2 + k]) << (8 * k);
+        for (int i = 0; i < 16; ++i)
+            rgba[i * 4 + 3] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+    }
+
+    // --- ETC2 ---
+
+    const int EtcModifiers[8][2] = { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+    const int EtcDistances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+    const int EacModifiers[16][8] = {
+        { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 }, { -2, -5, -8, -13, 1, 4, 7, 12 },
+        { -2, -4, -6, -13, 1, 3, 5, 12 }, { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+        { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 }, { -2, -6, -8, -10, 1, 5, 7, 9 },
+        { -2, -5, -8, -10, 1, 4, 7, 9 }, { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+        { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 }, { -4, -6, -8, -9, 3, 5, 7, 8 },
+        { -3, -5, -7, -9, 2, 4, 6, 8 }
+    };
+
+    uint64_t ReadBigEndian64(const uint8_t* p)
+    {
+        uint64_t v = 0;
+        for (int k = 0; k < 8; ++k) v = (v << 8) | p[k];
+        return v;
+    }
+
+    uint32_t Bits(uint64_t v, int high, int low) { return static_cast<uint32_t>((v >> low) & ((uint64_t(1) << (high - low + 1)) - 1)); }
+    int Extend4(uint32_t x) { return static_cast<int>((x << 4) | x); }
+    int Extend5(uint32_t x) { return static_cast<int>((x << 3) | (x >> 2)); }
+    int Extend6(uint32_t x) { return static_cast<int>((x << 2) | (x >> 4)); }
+    int Extend7(uint32_t x) { return static_cast<int>((x << 1) | (x >> 6)); }
+
+    // Indice de 2 bits del texel (x, y): los texels van por columnas, bit alto en los 16 bits de arriba
+    int EtcIndex(uint64_t v, int x, int y)
+    {
+        const int i = x * 4 + y;
+        return static_cast<int>(((v >> (i + 16)) & 1) << 1 | ((v >> i) & 1));
+    }
+
+    void SetRgb(uint8_t* rgba, int x, int y, int r, int g, int b)
+    {
+        uint8_t* p = rgba + (y * 4 + x) * 4;
+        p[0] = Clamp255(r);
+        p[1] = Clamp255(g);
+        p[2] = Clamp255(b);
+        p[3] = 255;
+    }
+
+    // Modos T y H: 4 colores de pintura elegidos directamente por el indice
+    void DecodeEtcPaint(uint64_t v, const int paint[4][3], uint8_t* rgba)
+    {
+        for (int y = 0; y < 4; ++y)
+            for (int x = 0; x < 4; ++x)
+            {
+                const int* c = paint[EtcIndex(v, x, y)];
+                SetRgb(rgba, x, y, c[0], c[1], c[2]);
+            }
+    }
+
+    void DecodeEtc2Rgb(const uint8_t* block, uint8_t* rgba)
+    {
+        const uint64_t v = ReadBigEndian64(block);
+        const bool differential = Bits(v, 33, 33) != 0;
+        const bool flip = Bits(v, 32, 32) != 0;
+        int base[2][3];
+
+        if (!differential)
+        {
+            for (int ch = 0; ch < 3; ++ch)
+            {
+                base[0][ch] = Extend4(Bits(v, 63 - ch * 8, 60 - ch * 8));
+                base[1][ch] = Extend4(Bits(v, 59 - ch * 8, 56 - ch * 8));
+            }
+        }
+        else
+        {
+            int c5[3], d3[3];
+            for (int ch = 0; ch < 3; ++ch)
+            {
+                c5[ch] = static_cast<int>(Bits(v, 63 - ch * 8, 59 - ch * 8));
+                const int d = static_cast<int>(Bits(v, 58 - ch * 8, 56 - ch * 8));
+                d3[ch] = d >= 4 ? d - 8 : d;
+            }
+
+            // Un segundo color fuera de rango no es un error: selecciona los modos de ETC2
+            if (c5[0] + d3[0] < 0 || c5[0] + d3[0] > 31)
+            {
+                // T: un color aislado y tres alrededor del otro
+                const int c1[3] = { Extend4(Bits(v, 60, 59) << 2 | Bits(v, 57, 56)), Extend4(Bits(v, 55, 52)), Extend4(Bits(v, 51, 48)) };
+                const int c2[3] = { Extend4(Bits(v, 47, 44)), Extend4(Bits(v, 43, 40)), Extend4(Bits(v, 39, 36)) };
+                const int d = EtcDistances[Bits(v, 35, 34) << 1 | Bits(v, 32, 32)];
+                const int paint[4][3] = { { c1[0], c1[1], c1[2] },
+                                          { c2[0] + d, c2[1] + d, c2[2] + d },
+                                          { c2[0], c2[1], c2[2] },
+                                          { c2[0] - d, c2[1] - d, c2[2] - d } };
+                DecodeEtcPaint(v, paint, rgba);
+                return;
+            }
+            if (c5[1] + d3[1] < 0 || c5[1] + d3[1] > 31)
+            {
+                // H: dos pares de colores alrededor de cada base
+                const uint32_t r1 = Bits(v, 62, 59), g1 = Bits(v, 58, 56) << 1 | Bits(v, 52, 52);
+                const uint32_t b1 = Bits(v, 51, 51) << 3 | Bits(v, 49, 47);
+                const uint32_t r2 = Bits(v, 46, 43), g2 = Bits(v, 42, 39), b2 = Bits(v, 38, 35);
+                const uint32_t order = ((r1 << 8 | g1 << 4 | b1) >= (r2 << 8 | g2 << 4 | b2)) ? 1 : 0;
+                const int d = EtcDistances[Bits(v, 34, 34) << 2 | Bits(v, 32, 32) << 1 | order];
+                const int c1[3] = { Extend4(r1), Extend4(g1), Extend4(b1) };
+                const int c2[3] = { Extend4(r2), Extend4(g2), Extend4(b2) };
+                const int paint[4][3] = { { c1[0] + d, c1[1] + d, c1[2] + d },
+                                          { c1[0] - d, c1[1] - d, c1[2] - d },
+                                          { c2[0] + d, c2[1] + d, c2[2] + d },
+                                          { c2[0] - d, c2[1] - d, c2[2] - d } };
+                DecodeEtcPaint(v, paint, rgba);
+                return;
+            }
+            if (c5[2] + d3[2] < 0 || c5[2] + d3[2] > 31)
+            {
+                // Planar: gradiente entre el origen y los colores en (4, 0) y (0, 4)
+                const int o[3] = { Extend6(Bits(v, 62, 57)), Extend7(Bits(v, 56, 56) << 6 | Bits(v, 54, 49)),
+                                   Extend6(Bits(v, 48, 48) << 5 | Bits(v, 44, 43) << 3 | Bits(v, 41, 39)) };
+                const int h[3] = { Extend6(Bits(v, 38, 34) << 1 | Bits(v, 32, 32)), Extend7(Bits(v, 31, 25)), Extend6(Bits(v, 24, 19)) };
+                const int vv[3] = { Extend6(Bits(v, 18, 13)), Extend7(Bits(v, 12, 6)), Extend6(Bits(v, 5, 0)) };
+                for (int y = 0; y < 4; ++y)
+                    for (int x = 0; x < 4; ++x)
+                    {
+                        int c[3];
+                        for (int ch = 0; ch < 3; ++ch)
+                            c[ch] = (x * (h[ch] - o[ch]) + y * (vv[ch] - o[ch]) + 4 * o[ch] + 2) >> 2;
+                        SetRgb(rgba, x, y, c[0], c[1], c[2]);
+                    }
+                return;
+            }
+            for (int ch = 0; ch < 3; ++ch)
+            {
+                base[0][ch] = Extend5(static_cast<uint32_t>(c5[ch]));
+                base[1][ch] = Extend5(static_cast<uint32_t>(c5[ch] + d3[ch]));
+            }
+        }
+
+        // ETC1: dos subbloques de 2x4 (o 4x2 con flip), cada uno con su color base y su tabla
+        const uint32_t table[2] = { Bits(v, 39, 37), Bits(v, 36, 34) };
+        for (int y = 0; y < 4; ++y)
+            for (int x = 0; x < 4; ++x)
+            {
+                const int sub = flip ? (y >= 2) : (x >= 2);
+                const int index = EtcIndex(v, x, y);
+                const int magnitude = EtcModifiers[table[sub]][index & 1];
+                const int modifier = (index & 2) ? -magnitude : magnitude;
+                SetRgb(rgba, x, y, base[sub][0] + modifier, base[sub][1] + modifier, base[sub][2] + modifier);
+            }
+    }
+
+    // Alfa EAC: base, multiplicador y tabla, 3 bits por texel (por columnas)
+    void DecodeEacAlpha(const uint8_t* block, uint8_t* rgba)
+    {
+        const uint64_t v = ReadBigEndian64(block);
+        const int base = static_cast<int>(Bits(v, 63, 56));
+        const int multiplier = static_cast<int>(Bits(v, 55, 52));
+        const int* modifiers = EacModifiers[Bits(v, 51, 48)];
+        for (int x = 0; x < 4; ++x)
+            for (int y = 0; y < 4; ++y)
+            {
+                const int i = x * 4 + y;
+                rgba[(y * 4 + x) * 4 + 3] = Clamp255(base + modifiers[Bits(v, 47 - i * 3, 45 - i * 3)] * multiplier);
+            }
+    }
+}
+
+namespace TextureCodec
+{
+    bool IsCompressed(TextureFormat format) { return format != TextureFormat::RGBA8; }
+
+    std::size_t BlockBytes(TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::RGBA8: return 4;
+        case TextureFormat::BC1_RGB: case TextureFormat::BC1_RGBA: case TextureFormat::ETC2_RGB8: return 8;
+        default: return 16;
+        }
+    }
+
+    std::size_t LevelBytes(TextureFormat format, int width, int height)
+    {
+        if (!IsCompressed(format)) return static_cast<std::size_t>(width) * height * 4;
+        return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+    }
+
+    bool ParseKtx2(const std::string& bytes, ImageData& out, std::string& error)
+    {
+        static const uint8_t identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.data());
+        if (bytes.size() < 80 || std::memcmp(data, identifier, 12) != 0)
+        {
+            error = "not a KTX2 file";
+            return false;
+        }
+
+        const uint32_t vkFormat = ReadU32(data + 12);
+        const uint32_t width = ReadU32(data + 20), height = ReadU32(data + 24), depth = ReadU32(data + 28);
+        const uint32_t layers = ReadU32(data + 32), faces = ReadU32(data + 36), levelCount = ReadU32(data + 40);
+        const uint32_t supercompression = ReadU32(data + 44);
+
+        out = ImageData();
+        if (!FormatFromVk(vkFormat, out.format))
+        {
+            error = "unsupported vkFormat " + std::to_string(vkFormat);
+            return false;
+        }
+        if (supercompression != 0)
+        {
+            error = "supercompressed KTX2 (Basis/zstd) is not supported";
+            return false;
+        }
+        if (width == 0 || height == 0 || width > 16384 || height > 16384 || depth > 1 || layers > 1 || faces != 1)
+        {
+            error = "only single 2D images are supported";
+            return false;
+        }
+        if (levelCount == 0 && IsCompressed(out.format))
+        {
+            error = "compressed KTX2 without mip chain";
+            return false;
+        }
+
+        out.width = static_cast<int>(width);
+        out.height = static_cast<int>(height);
+        const uint32_t stored = std::max(levelCount, 1u);
+        // Un nivel de mas no cabe: la cadena completa acaba en 1x1
+        int fullChain = 1;
+        while ((out.width >> fullChain) > 0 || (out.height >> fullChain) > 0) ++fullChain;
+        if (stored > static_cast<uint32_t>(fullChain) || bytes.size() < 80 + stored * 24)
+        {
+            error = "bad level count";
+            return false;
+        }
+
+        out.levels.resize(stored);
+        for (uint32_t level = 0; level < stored; ++level)
+        {
+            const uint8_t* index = data + 80 + level * 24;
+            const uint64_t offset = ReadU64(index);
+            const uint64_t length = ReadU64(index + 8);
+            const std::size_t expected = LevelBytes(out.format, out.LevelWidth(level), out.LevelHeight(level));
+            if (length != expected || offset > bytes.size() || length > bytes.size() - offset)
+            {
+                error = "bad level " + std::to_string(level);
+                out = ImageData();
+                return false;
+            }
+            out.levels[level].assign(data + offset, data + offset + length);
+        }
+        if (levelCount == 0) BuildMipChain(out);
+        return true;
+    }
+
+    void BuildMipChain(ImageData& image)
+    {
+        if (IsCompressed(image.format) || image.levels.empty()) return;
+        image.levels.resize(1);
+        for (int level = 1; image.LevelWidth(level - 1) > 1 || image.LevelHeight(level - 1) > 1; ++level)
+        {
+            const int srcW = image.LevelWidth(level - 1), srcH = image.LevelHeight(level - 1);
+            const int w = image.LevelWidth(level), h = image.LevelHeight(level);
+            const std::vector<uint8_t>& src = image.levels[level - 1];
+            std::vector<uint8_t> dst(static_cast<std::size_t>(w) * h * 4);
+            for (int y = 0; y < h; ++y)
+                for (int x = 0; x < w; ++x)
+                {
+                    // Con un lado impar (o ya en 1) se repite el ultimo texel
+                    const int x0 = std::min(x * 2, srcW - 1), x1 = std::min(x * 2 + 1, srcW - 1);
+                    const int y0 = std::min(y * 2, srcH - 1), y1 = std::min(y * 2 + 1, srcH - 1);
+                    for (int ch = 0; ch < 4; ++ch)
+                    {
+                        const int sum = src[(y0 * srcW + x0) * 4 + ch] + src[(y0 * srcW + x1) * 4 + ch] +
+                                        src[(y1 * srcW + x0) * 4 + ch] + src[(y1 * srcW + x1) * 4 + ch];
+                        dst[(y * w + x) * 4 + ch] = static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            image.levels.push_back(std::move(dst));
+        }
+    }
+
+    void DecodeBlock(TextureFormat format, const uint8_t* block, uint8_t* rgba)
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1_RGB: DecodeBc1Color(block, rgba, false, false); break;
+        case TextureFormat::BC1_RGBA: DecodeBc1Color(block, rgba, false, true); break;
+        case TextureFormat::BC3:
+            DecodeBc1Color(block + 8, rgba, true, false);
+            DecodeBc3Alpha(block, rgba);
+            break;
+        case TextureFormat::ETC2_RGB8: DecodeEtc2Rgb(block, rgba); break;
+        case TextureFormat::ETC2_RGBA8:
+            DecodeEtc2Rgb(block + 8, rgba);
+            DecodeEacAlpha(block, rgba);
+            break;
+        case TextureFormat::RGBA8: std::memcpy(rgba, block, 64); break;
+        }
+    }
+
+    void DecodeToRgba8(ImageData& image)
+    {
+        if (!IsCompressed(image.format)) return;
+        const std::size_t blockBytes = BlockBytes(image.format);
+        for (int level = 0; level < image.LevelCount(); ++level)
+        {
+            const int w = image.LevelWidth(level), h = image.LevelHeight(level);
+            const uint8_t* src = image.levels[level].data();
+            std::vector<uint8_t> dst(static_cast<std::size_t>(w) * h * 4);
+            uint8_t texels[64];
+            for (int by = 0; by < h; by += 4)
+                for (int bx = 0; bx < w; bx += 4, src += blockBytes)
+                {
+                    DecodeBlock(image.format, src, texels);
+                    // Los bloques del borde de un nivel de 2x2 o 1x1 se recortan
+                    for (int y = 0; y < 4 && by + y < h; ++y)
+                        for (int x = 0; x < 4 && bx + x < w; ++x)
+                            std::memcpy(&dst[((by + y) * w + bx + x) * 4], texels + (y * 4 + x) * 4, 4);
+                }
+            image.levels[level] = std::move(dst);
+        }
+        image.format = TextureFormat::RGBA8;
+    }
+}
\ No newline at end of file
@@ -1,8 +1,9 @@
 #include "Transform.hpp"
 
-Matrix4x4 Transform::GetLocalMatrix() const
+Affine3 Transform::GetLocalMatrix() const
 {
-    return Matrix4x4::FromTRS(position, rotation, scale);
+    // rotation siempre es unitario (SetEulerRotation / Normalized): sin renormalizar
+    return Affine3::FromTRS(position, rotation.ToMatrix3x3Unchecked(), scale);
 }
 
 void Transform::SetEulerRotation(const Vec3& euler)
@@ -15,4 +16,17 @@ void Transform::SetEulerRotation(const Vec3& euler)
         euler.y,   // pitch
         euler.z    // roll
     );
+}
+
+Transform Transform::Interpolate(const Transform& a, const Transform& b, double t)
+{
+    Transform r = b;
+    r.position = { a.position.x + (b.position.x - a.position.x) * t,
+                   a.position.y + (b.position.y - a.position.y) * t,
+                   a.position.z + (b.position.z - a.position.z) * t };
+    r.scale = { a.scale.x + (b.scale.x - a.scale.x) * t,
+                a.scale.y + (b.scale.y - a.scale.y) * t,
+                a.scale.z + (b.scale.z - a.scale.z) * t };
+    r.rotation = Quat::Slerp(a.rotation, b.rotation, t);
+    return r;
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "WorldPartition.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+std::string WorldPartition::CellFileName(int x, int z)
+{
+    return "cell_" + std::to_string(x) + "_" + std::to_string(z) + ".scene";
+}
+
+bool WorldPartition::Open(const std::string& indexPath, std::string& error)
+{
+    std::ifstream file(indexPath);
+    if (!file)
+    {
+        error = "cannot read " + indexPath;
+        return false;
+    }
+
+    double size = 0.0;
+    std::vector<Cell> list;
+    std::string lineText;
+    int line = 0;
+    while (std::getline(file, lineText))
+    {
+        ++line;
+        std::istringstream ls(lineText);
+        std::string keyword;
+        if (!(ls >> keyword) || keyword[0] == '#') continue;
+
+        if (keyword == "cellSize")
+        {
+            if (!(ls >> size) || size <= 0.0)
+            {
+                error = "bad cellSize at line " + std::to_string(line);
+                return false;
+            }
+        }
+        else if (keyword == "cell")
+        {
+            Cell cell;
+            if (!(ls >> cell.x >> cell.z))
+            {
+                error = "malformed cell at line " + std::to_string(line);
+                return false;
+            }
+            list.push_back(cell);
+        }
+        else
+        {
+            error = "unknown keyword '" + keyword + "' at line " + std::to_string(line);
+            return false;
+        }
+    }
+    if (size <= 0.0)
+    {
+        error = "missing cellSize";
+        return false;
+    }
+
+    directory = std::filesystem::path(indexPath).parent_path().string();
+    cellSize = size;
+    cells = std::move(list);
+    byCoord.clear();
+    byScene.clear();
+    active.clear();
+    loaded = 0;
+    for (std::size_t i = 0; i < cells.size(); ++i)
+        byCoord[Key(cells[i].x, cells[i].z)] = i;
+    return true;
+}
+
+void WorldPartition::Close(AssetManager& assets, std::vector<GameObject*>& sceneRoots, std::vector<GameObject*>& unloaded)
+{
+    while (!active.empty())
+        Unload(active.size() - 1, assets, sceneRoots, unloaded);
+    cells.clear();
+    byCoord.clear();
+    cellSize = 0.0;
+}
+
+double WorldPartition::Distance(const Cell& cell, const Vec3& p) const
+{
+    // Al punto mas cercano del cuadrado (0 si la camara esta dentro)
+    const double minX = cell.x * cellSize, minZ = cell.z * cellSize;
+    const double dx = std::max({ minX - p.x, 0.0, p.x - (minX + cellSize) });
+    const double dz = std::max({ minZ - p.z, 0.0, p.z - (minZ + cellSize) });
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+void WorldPartition::Unload(std::size_t index, AssetManager& assets, std::vector<GameObject*>& sceneRoots, std::vector<GameObject*>& unloaded)
+{
+    Cell& cell = cells[active[index]];
+    if (cell.root)
+    {
+        sceneRoots.erase(std::find(sceneRoots.begin(), sceneRoots.end(), cell.root));
+        unloaded.push_back(cell.root);
+        cell.root = nullptr;
+        --loaded;
+    }
+    // Si aun no habia llegado, AssetManager la descarta al terminar de decodificarla
+    byScene.erase(cell.scene.id);
+    assets.Release(cell.scene);
+    cell.scene = AssetHandle();
+
+    active[index] = active.back();
+    active.pop_back();
+}
+
+void WorldPartition::Update(const Vec3& cameraPos, AssetManager& assets, std::vector<GameObject*>& sceneRoots, std::vector<GameObject*>& unloaded)
+{
+    if (!IsOpen()) return;
+
+    for (std::size_t i = 0; i < active.size();)
+    {
+        Cell& cell = cells[active[i]];
+        const bool failed = !cell.root && assets.State(cell.scene) == AssetState::Failed;
+        if (failed) cell.failed = true;
+        if (failed || Distance(cell, cameraPos) > unloadRadius)
+            Unload(i, assets, sceneRoots, unloaded);
+        else
+            ++i;
+    }
+
+    const int x0 = static_cast<int>(std::floor((cameraPos.x - loadRadius) / cellSize));
+    const int x1 = static_cast<int>(std::floor((cameraPos.x + loadRadius) / cellSize));
+    const int z0 = static_cast<int>(std::floor((cameraPos.z - loadRadius) / cellSize));
+    const int z1 = static_cast<int>(std::floor((cameraPos.z + loadRadius) / cellSize));
+    for (int z = z0; z <= z1; ++z)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            const auto it = byCoord.find(Key(x, z));
+            if (it == byCoord.end()) continue;
+            Cell& cell = cells[it->second];
+            if (cell.scene.Valid() || cell.failed || Distance(cell, cameraPos) > loadRadius) continue;
+
+            cell.scene = assets.LoadScene((std::filesystem::path(directory) / CellFileName(x, z)).string());
+            byScene[cell.scene.id] = it->second;
+            active.push_back(it->second);
+        }
+    }
+}
+
+std::size_t WorldPartition::Adopt(std::vector<LoadedAsset>& arrived, std::vector<GameObject*>& sceneRoots)
+{
+    std::size_t adopted = 0;
+    for (std::size_t i = 0; i < arrived.size();)
+    {
+        const auto it = byScene.find(arrived[i].handle.id);
+        if (it == byScene.end())
+        {
+            ++i;
+            continue;
+        }
+
+        Cell& cell = cells[it->second];
+        GameObject* root = new GameObject("Cell " + std::to_string(cell.x) + "," + std::to_string(cell.z));
+        for (GameObject* node : arrived[i].roots)
+            root->AddChild(node);
+        cell.root = root;
+        sceneRoots.push_back(root);
+        ++loaded;
+        ++adopted;
+        arrived.erase(arrived.begin() + i);
+    }
+    return adopted;
+}
+
+bool WorldPartition::Export(const std::string& dir, double cellSize, const std::vector<GameObject*>& roots,
+                            const std::function<std::string(uint32_t)>& assetPath, std::string& error)
+{
+    if (cellSize <= 0.0)
+    {
+        error = "cellSize must be > 0";
+        return false;
+    }
+
+    // Ordenadas para que el indice salga igual en cada exportacion
+    std::map<std::pair<int, int>, std::vector<GameObject*>> buckets;
+    for (GameObject* root : roots)
+    {
+        const Vec3 p = root->GetGlobalMatrix().Translation();
+        buckets[{ static_cast<int>(std::floor(p.x / cellSize)), static_cast<int>(std::floor(p.z / cellSize)) }].push_back(root);
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    std::ofstream index(std::filesystem::path(dir) / "world.txt", std::ios::trunc);
+    if (!index)
+    {
+        error = "cannot write " + (std::filesystem::path(dir) / "world.txt").string();
+        return false;
+    }
+    index << "# Indice de WorldPartition: tamano de celda y celdas con fichero\n";
+    index << std::setprecision(12) << "cellSize " << cellSize << '\n';
+
+    for (const auto& bucket : buckets)
+    {
+        const std::filesystem::path path = std::filesystem::path(dir) / CellFileName(bucket.first.first, bucket.first.second);
+        std::ofstream file(path, std::ios::trunc);
+        if (!file || !(file << AssetManager::SerializeScene(bucket.second, assetPath)))
+        {
+            error = "cannot write " + path.string();
+            return false;
+        }
+        index << "cell " << bucket.first.first << ' ' << bucket.first.second << '\n';
+    }
+    return static_cast<bool>(index);
+}
\ No newline at end of file
@@ -1,12 +1,141 @@
 #version 330 core
+// Fuente de todas las variantes: ShaderVariants anade los #define (INSTANCED, SKINNED, DUAL_QUAT,
+// LIT, ALPHA_TEST, CLUSTERED) detras de #version
+#if defined(LIT) || defined(CLUSTERED)
+#define SHADED
+#endif
+
 layout (location = 0) in vec3 aPos;
+#if defined(SKINNED) || defined(SHADED)
+layout (location = 1) in vec3 aNormal;
+#endif
 
+#ifdef INSTANCED
+// Solo las mallas de la escena traen UV; los personajes con skinning no tienen textura
+layout (location = 2) in vec2 aUV;
+out vec2 v_UV;
+// Global 3x4 por instancia (Affine3f): cada columna del mat3x4 es una fila de la matriz
+layout (location = 5) in mat3x4 aModel;
+#else
 uniform mat4 u_Model;
+#endif
+
+#ifdef SKINNED
+layout (location = 3) in uvec4 aJoints;
+layout (location = 4) in vec4 aWeights;
+
+#ifdef DUAL_QUAT
+// Paleta de dual quats: 2 vec4 por joint, real y dual como (x, y, z, w)
+layout (std140) uniform SkinPalette
+{
+    vec4 u_DualQuats[256 * 2];
+};
+#else
+// Paleta 3x4 row-major: 3 vec4 por joint (Skeleton::MaxJoints = 256)
+layout (std140) uniform SkinPalette
+{
+    vec4 u_Palette[256 * 3];
+};
+#endif
+#endif
+
+#ifdef SHADED
+out vec3 v_WorldPos; // ejes de mundo, origen junto a la camara (u_Model ya viene trasladado)
+out vec3 v_Normal;
+#endif
+#ifdef CLUSTERED
+out float v_ViewDepth;
+#endif
+
 uniform mat4 u_View;
 uniform mat4 u_Projection;
 
+#if defined(SKINNED) && defined(DUAL_QUAT)
+vec3 RotateByQuat(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+vec3 Skin(out vec3 normal)
+{
+    // Mezcla lineal de dual quats en el hemisferio del primer joint
+    vec4 q0 = u_DualQuats[int(aJoints[0]) * 2];
+    vec4 real = vec4(0.0), dual = vec4(0.0);
+    for (int i = 0; i < 4; ++i)
+    {
+        int j = int(aJoints[i]) * 2;
+        vec4 r = u_DualQuats[j];
+        float w = dot(r, q0) < 0.0 ? -aWeights[i] : aWeights[i];
+        real += w * r;
+        dual += w * u_DualQuats[j + 1];
+    }
+
+    float len = length(real);
+    real /= len;
+    dual /= len;
+
+    vec3 t = 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+    normal = RotateByQuat(real, aNormal);
+    return RotateByQuat(real, aPos) + t;
+}
+#elif defined(SKINNED)
+vec3 Skin(out vec3 normal)
+{
+    vec4 r0 = vec4(0.0), r1 = vec4(0.0), r2 = vec4(0.0);
+    for (int i = 0; i < 4; ++i)
+    {
+        int j = int(aJoints[i]) * 3;
+        r0 += aWeights[i] * u_Palette[j];
+        r1 += aWeights[i] * u_Palette[j + 1];
+        r2 += aWeights[i] * u_Palette[j + 2];
+    }
+
+    vec4 p = vec4(aPos, 1.0);
+    vec4 n = vec4(aNormal, 0.0);
+    normal = normalize(vec3(dot(r0, n), dot(r1, n), dot(r2, n)));
+    return vec3(dot(r0, p), dot(r1, p), dot(r2, p));
+}
+#endif
+
+#ifdef SHADED
+// Inversa traspuesta salvo escala (cofactores de las columnas): vale con escala no uniforme
+vec3 TransformNormal(mat3 m, vec3 n)
+{
+    return cross(m[1], m[2]) * n.x + cross(m[2], m[0]) * n.y + cross(m[0], m[1]) * n.z;
+}
+#endif
+
 void main()
 {
+    vec3 normal = vec3(0.0);
+#ifdef SKINNED
+    vec3 pos = Skin(normal);
+#else
+    vec3 pos = aPos;
+#ifdef SHADED
+    normal = aNormal;
+#endif
+#endif
+
     // TODO: Calcular gl_Position
-    gl_Position = u_Projection * u_View * u_Model * vec4(aPos, 1.0);
+#ifdef INSTANCED
+    vec3 worldPos = vec4(pos, 1.0) * aModel;
+    mat3 linear = transpose(mat3(aModel));
+#else
+    vec3 worldPos = (u_Model * vec4(pos, 1.0)).xyz;
+    mat3 linear = mat3(u_Model);
+#endif
+
+#ifdef INSTANCED
+    v_UV = aUV;
+#endif
+#ifdef SHADED
+    v_WorldPos = worldPos;
+    v_Normal = TransformNormal(linear, normal);
+#endif
+    vec4 viewPos = u_View * vec4(worldPos, 1.0);
+#ifdef CLUSTERED
+    v_ViewDepth = -viewPos.z;
+#endif
+    gl_Position = u_Projection * viewPos;
 }
\ No newline at end of file